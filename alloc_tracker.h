@@ -0,0 +1,182 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <ostream>
+#include <unordered_map>
+#include <algorithm>
+#include <utility>
+
+// Opt-in heap instrumentation. Build with SNAKE_ALLOC_TRACKING defined and include this header from exactly one
+// translation unit of the program: it replaces the global operator new/delete there.
+enum class AllocTag : std::uint8_t { Other, Render, Text, Leaderboard, Score, Assets, Audio, Sim, Replay, Network, Count };
+
+struct AllocPhaseStats {
+    std::uint64_t samples = 0, allocations = 0, maxAllocations = 0;
+
+    void add(std::uint64_t count){
+        samples++, allocations += count, maxAllocations = std::max(maxAllocations, count);
+    }
+};
+
+class AllocTracker {
+    public:
+    using PhaseStats = AllocPhaseStats;
+    static constexpr std::size_t tagCount = static_cast<std::size_t>(AllocTag::Count);
+    static constexpr std::array<std::string_view, tagCount> tagNames = {"other", "render", "text", "leaderboard", "score", "assets", "audio", "sim", "replay", "network"};
+    static constexpr std::array<std::string_view, 7> screenNames = {"menu", "select_mode", "setup", "leaderboard", "quit_prompt", "game", "login"};
+    static constexpr std::uint64_t unlimited = UINT64_MAX;
+
+    // Text file of key=value lines: frame, tick, texture_bytes and frame.<screen>, each a maximum.
+    struct Budget {
+        std::uint64_t perFrame = unlimited, perTick = unlimited, textureBytes = unlimited;
+        std::array<std::uint64_t, screenNames.size()> perScreenFrame;
+
+        Budget(){
+            perScreenFrame.fill(unlimited);
+        }
+
+        bool load(const std::string& path){
+            std::ifstream file(path);
+            if (!file) return false;
+            std::string line;
+            while (std::getline(file, line)){
+                std::size_t equals = line.find('=');
+                if (line.empty() || line[0] == '#' || equals == std::string::npos) continue;
+                std::string_view key = std::string_view(line).substr(0, equals);
+                std::uint64_t value = std::strtoull(line.c_str() + equals + 1, nullptr, 10);
+                if (key == "frame") perFrame = value;
+                else if (key == "tick") perTick = value;
+                else if (key == "texture_bytes") textureBytes = value;
+                for (std::size_t i = 0; i < screenNames.size(); i++){
+                    if (key.size() == screenNames[i].size() + 6 && key.substr(0, 6) == "frame." && key.substr(6) == screenNames[i]) perScreenFrame[i] = value;
+                }
+            }
+            return true;
+        }
+    };
+
+    class Scope {
+        public:
+        Scope(AllocTag tag) : previous{currentTag} { currentTag = tag; }
+        ~Scope(){ currentTag = previous; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        private:
+        AllocTag previous;
+    };
+
+    static void record(std::size_t size){
+        threadAllocations++;
+        std::size_t tag = static_cast<std::size_t>(currentTag);
+        tagAllocations[tag].fetch_add(1, std::memory_order_relaxed);
+        tagBytes[tag].fetch_add(size, std::memory_order_relaxed);
+    }
+
+    // Frames are closed by the render thread and ticks by the simulation thread; each keeps its own mark.
+    static void endFrame(int screen){
+        static std::uint64_t mark = 0;
+        static bool isStarted = false;
+        std::uint64_t count = threadAllocations - mark;
+        mark = threadAllocations;
+        if (!std::exchange(isStarted, true)) return;
+        frames[std::clamp<std::size_t>(static_cast<std::size_t>(screen), 0, screenNames.size() - 1)].add(count);
+    }
+
+    static void endTick(){
+        static std::uint64_t mark = 0;
+        static bool isStarted = false;
+        std::uint64_t count = threadAllocations - mark;
+        mark = threadAllocations;
+        if (!std::exchange(isStarted, true)) return;
+        ticks.add(count);
+    }
+
+    static void setTextureBytes(const void* texture, std::uint64_t bytes){
+        std::uint64_t& current = textures[texture];
+        residentTextureBytes += bytes - current;
+        current = bytes;
+        peakTextureBytes = std::max(peakTextureBytes, residentTextureBytes);
+    }
+
+    static std::uint64_t threadAllocationCount(){ return threadAllocations; }
+    static const PhaseStats& frameStats(std::size_t screen){ return frames[screen]; }
+    static const PhaseStats& tickStats(){ return ticks; }
+    static std::uint64_t peakTextures(){ return peakTextureBytes; }
+
+    static bool report(std::ostream& out, const Budget& budget){
+        bool isWithinBudget = true;
+        auto check = [&](std::string_view what, std::uint64_t value, std::uint64_t limit){
+            if (limit == unlimited || value <= limit) return;
+            out << "  OVER BUDGET: " << what << " " << value << " > " << limit << "\n";
+            isWithinBudget = false;
+        };
+        out << "Allocation report\n";
+        for (std::size_t tag = 0; tag < tagCount; tag++){
+            std::uint64_t count = tagAllocations[tag].load(std::memory_order_relaxed);
+            if (count) out << "  " << tagNames[tag] << ": " << count << " allocations, " << tagBytes[tag].load(std::memory_order_relaxed) << " bytes\n";
+        }
+        for (std::size_t screen = 0; screen < screenNames.size(); screen++){
+            const PhaseStats& stats = frames[screen];
+            if (!stats.samples) continue;
+            out << "  frames on " << screenNames[screen] << ": " << stats.samples << ", " << static_cast<double>(stats.allocations) / stats.samples << " allocations per frame, worst " << stats.maxAllocations << "\n";
+            check("worst frame on " + std::string(screenNames[screen]), stats.maxAllocations, std::min(budget.perFrame, budget.perScreenFrame[screen]));
+        }
+        if (ticks.samples) out << "  ticks: " << ticks.samples << ", " << static_cast<double>(ticks.allocations) / ticks.samples << " allocations per tick, worst " << ticks.maxAllocations << "\n";
+        check("worst tick", ticks.maxAllocations, budget.perTick);
+        out << "  peak resident textures: " << peakTextureBytes / 1024 << " KiB\n";
+        check("peak texture bytes", peakTextureBytes, budget.textureBytes);
+        return isWithinBudget;
+    }
+
+    private:
+    static inline thread_local AllocTag currentTag = AllocTag::Other;
+    static inline thread_local std::uint64_t threadAllocations = 0;
+    static inline std::array<std::atomic<std::uint64_t>, tagCount> tagAllocations{}, tagBytes{};
+    static inline std::array<PhaseStats, screenNames.size()> frames{};
+    static inline PhaseStats ticks{};
+    static inline std::unordered_map<const void*, std::uint64_t> textures;
+    static inline std::uint64_t residentTextureBytes = 0, peakTextureBytes = 0;
+};
+
+#if defined(SNAKE_ALLOC_TRACKING)
+#define SNAKE_ALLOC_CONCAT_(a, b) a##b
+#define SNAKE_ALLOC_CONCAT(a, b) SNAKE_ALLOC_CONCAT_(a, b)
+#define SNAKE_ALLOC_SCOPE(tag) AllocTracker::Scope SNAKE_ALLOC_CONCAT(allocScope, __LINE__)(tag)
+#define SNAKE_ALLOC_END_FRAME(screen) AllocTracker::endFrame(screen)
+#define SNAKE_ALLOC_END_TICK() AllocTracker::endTick()
+#define SNAKE_ALLOC_TEXTURE(texture) AllocTracker::setTextureBytes(&(texture), std::uint64_t((texture).getSize().x) * (texture).getSize().y * 4)
+
+// Kept out of line so GCC does not pair an inlined free() or operator new with the counterpart it can see at the call site.
+#if defined(__GNUC__)
+#define SNAKE_ALLOC_NOINLINE __attribute__((noinline))
+#else
+#define SNAKE_ALLOC_NOINLINE
+#endif
+
+void* operator new(std::size_t size){
+    AllocTracker::record(size);
+    if (void* block = std::malloc(size ? size : 1)) return block;
+    throw std::bad_alloc();
+}
+
+SNAKE_ALLOC_NOINLINE void* operator new[](std::size_t size){
+    return operator new(size);
+}
+
+SNAKE_ALLOC_NOINLINE void operator delete(void* block) noexcept { std::free(block); }
+SNAKE_ALLOC_NOINLINE void operator delete[](void* block) noexcept { std::free(block); }
+SNAKE_ALLOC_NOINLINE void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+SNAKE_ALLOC_NOINLINE void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+#else
+#define SNAKE_ALLOC_SCOPE(tag) ((void)0)
+#define SNAKE_ALLOC_END_FRAME(screen) ((void)0)
+#define SNAKE_ALLOC_END_TICK() ((void)0)
+#define SNAKE_ALLOC_TEXTURE(texture) ((void)0)
+#endif
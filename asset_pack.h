@@ -0,0 +1,170 @@
+#pragma once
+#include "mapped_file.h"
+#include <zlib.h>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <span>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <bit>
+#include <iostream>
+
+static_assert(std::endian::native == std::endian::little, "Asset packs are stored little-endian");
+
+struct AssetPackHeader {
+    std::uint32_t magic, version, entryCount, namesSize;
+    std::uint64_t namesOffset, totalSize;
+};
+
+struct AssetEntry {
+    std::uint64_t offset, contentHash;
+    std::uint32_t storedSize, rawSize, nameOffset;
+    std::uint16_t nameSize;
+    std::uint8_t compression, reserved;
+};
+
+static_assert(sizeof(AssetPackHeader) == 32 && sizeof(AssetEntry) == 32);
+
+class AssetPack {
+    public:
+    enum Compression : std::uint8_t { Stored, Zlib };
+    static constexpr std::uint32_t magic = 0x414B4E53, version = 1;
+    static constexpr std::size_t dataAlignment = 16;
+
+    struct Source {
+        std::string name;
+        std::vector<std::uint8_t> data;
+    };
+
+    bool open(const std::string& path){
+        close();
+        if (!file.open(path)) return false;
+        if (!parse(file.data(), file.size())){
+            std::cerr << "Asset pack " << path << " is corrupt or from a different version, using loose files\n";
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close(){
+        file.close();
+        base = nullptr, entries = {}, names = {};
+        inflated.clear(), checked.clear();
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    std::size_t size() const { return entries.size(); }
+    const AssetEntry& entry(std::size_t index) const { return entries[index]; }
+    std::string_view name(std::size_t index) const { return names.substr(entries[index].nameOffset, entries[index].nameSize); }
+
+    bool parse(const std::uint8_t* data, std::size_t size){
+        if (size < sizeof(AssetPackHeader)) return false;
+        const AssetPackHeader& head = *reinterpret_cast<const AssetPackHeader*>(data);
+        if (head.magic != magic || head.version != version || head.totalSize != size || head.entryCount > (size - sizeof(AssetPackHeader)) / sizeof(AssetEntry)) return false;
+        if (head.namesOffset > size || head.namesSize > size - head.namesOffset) return false;
+        std::span<const AssetEntry> table(reinterpret_cast<const AssetEntry*>(data + sizeof(AssetPackHeader)), head.entryCount);
+        std::string_view nameBlob(reinterpret_cast<const char*>(data + head.namesOffset), head.namesSize);
+        for (std::size_t i = 0; i < table.size(); i++){
+            const AssetEntry& item = table[i];
+            if (item.offset > size || item.storedSize > size - item.offset || item.nameOffset > nameBlob.size() || item.nameSize > nameBlob.size() - item.nameOffset) return false;
+            if (item.compression > Zlib || (item.compression == Stored && item.storedSize != item.rawSize)) return false;
+            if (i > 0 && nameBlob.substr(table[i - 1].nameOffset, table[i - 1].nameSize) >= nameBlob.substr(item.nameOffset, item.nameSize)) return false;
+        }
+        base = data, entries = table, names = nameBlob;
+        inflated.resize(table.size()), checked.assign(table.size(), Unchecked);
+        return true;
+    }
+
+    int find(std::string_view assetName) const {
+        auto found = std::lower_bound(entries.begin(), entries.end(), assetName, [&](const AssetEntry& item, std::string_view key){ return names.substr(item.nameOffset, item.nameSize) < key; });
+        if (found == entries.end() || names.substr(found->nameOffset, found->nameSize) != assetName) return -1;
+        return static_cast<int>(found - entries.begin());
+    }
+
+    std::span<const std::uint8_t> view(std::size_t index){
+        const AssetEntry& item = entries[index];
+        std::span<const std::uint8_t> data(base + item.offset, item.storedSize);
+        if (item.compression == Zlib){
+            if (!inflated[index]){
+                auto buffer = std::make_unique<std::uint8_t[]>(item.rawSize);
+                uLongf rawSize = item.rawSize;
+                if (uncompress(buffer.get(), &rawSize, data.data(), data.size()) != Z_OK || rawSize != item.rawSize) checked[index] = Corrupt;
+                else inflated[index] = std::move(buffer);
+            }
+            data = inflated[index] ? std::span<const std::uint8_t>(inflated[index].get(), item.rawSize) : std::span<const std::uint8_t>();
+        }
+        if (checked[index] == Unchecked) checked[index] = fnv1aHash(data.data(), data.size()) == item.contentHash ? Intact : Corrupt;
+        if (checked[index] == Intact) return data;
+        std::cerr << "Asset " << name(index) << " failed its content hash check\n";
+        return {};
+    }
+
+    std::span<const std::uint8_t> view(std::string_view assetName){
+        int index = find(assetName);
+        return index < 0 ? std::span<const std::uint8_t>() : view(static_cast<std::size_t>(index));
+    }
+
+    template <typename Resource>
+    bool load(Resource& resource, const std::string& path){
+        std::span<const std::uint8_t> data = isOpen() ? view(path) : std::span<const std::uint8_t>();
+        if (!data.empty()) return resource.loadFromMemory(data.data(), data.size());
+        return resource.loadFromFile(path);
+    }
+
+    template <typename Stream>
+    bool openStream(Stream& stream, const std::string& path){
+        std::span<const std::uint8_t> data = isOpen() ? view(path) : std::span<const std::uint8_t>();
+        if (!data.empty()) return stream.openFromMemory(data.data(), data.size());
+        return stream.openFromFile(path);
+    }
+
+    static std::vector<std::uint8_t> build(std::vector<Source> sources, bool isCompressed = true){
+        std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b){ return a.name < b.name; });
+        std::string nameBlob;
+        std::vector<AssetEntry> table(sources.size());
+        for (std::size_t i = 0; i < sources.size(); i++){
+            table[i].nameOffset = static_cast<std::uint32_t>(nameBlob.size()), table[i].nameSize = static_cast<std::uint16_t>(sources[i].name.size());
+            nameBlob += sources[i].name;
+        }
+        std::size_t namesOffset = sizeof(AssetPackHeader) + table.size() * sizeof(AssetEntry);
+        std::vector<std::uint8_t> out(align(namesOffset + nameBlob.size()), 0);
+        std::memcpy(out.data() + namesOffset, nameBlob.data(), nameBlob.size());
+        for (std::size_t i = 0; i < sources.size(); i++){
+            const std::vector<std::uint8_t>& raw = sources[i].data;
+            std::vector<std::uint8_t> packed;
+            if (isCompressed && !raw.empty()){
+                uLongf packedSize = compressBound(raw.size());
+                packed.resize(packedSize);
+                if (compress2(packed.data(), &packedSize, raw.data(), raw.size(), Z_BEST_COMPRESSION) == Z_OK) packed.resize(packedSize);
+                else packed.clear();
+            }
+            bool isWorthIt = !packed.empty() && packed.size() + raw.size() / 8 < raw.size();
+            const std::vector<std::uint8_t>& stored = isWorthIt ? packed : raw;
+            table[i].offset = out.size(), table[i].contentHash = fnv1aHash(raw.data(), raw.size());
+            table[i].storedSize = static_cast<std::uint32_t>(stored.size()), table[i].rawSize = static_cast<std::uint32_t>(raw.size());
+            table[i].compression = isWorthIt ? Zlib : Stored;
+            out.insert(out.end(), stored.begin(), stored.end());
+            out.resize(align(out.size()), 0);
+        }
+        AssetPackHeader head{magic, version, static_cast<std::uint32_t>(table.size()), static_cast<std::uint32_t>(nameBlob.size()), namesOffset, out.size()};
+        std::memcpy(out.data(), &head, sizeof(head));
+        if (!table.empty()) std::memcpy(out.data() + sizeof(AssetPackHeader), table.data(), table.size() * sizeof(AssetEntry));
+        return out;
+    }
+
+    private:
+    enum CheckState : std::uint8_t { Unchecked, Intact, Corrupt };
+    MappedFile file;
+    const std::uint8_t* base = nullptr;
+    std::span<const AssetEntry> entries;
+    std::string_view names;
+    std::vector<std::unique_ptr<std::uint8_t[]>> inflated;
+    std::vector<std::uint8_t> checked;
+
+    static std::size_t align(std::size_t offset){
+        return (offset + dataAlignment - 1) & ~(dataAlignment - 1);
+    }
+};
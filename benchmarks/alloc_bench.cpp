@@ -0,0 +1,85 @@
+#ifndef SNAKE_ALLOC_TRACKING
+#define SNAKE_ALLOC_TRACKING
+#endif
+#include "../alloc_tracker.h"
+#include "../snake_replay.h"
+#include "../leaderboard_table.h"
+
+// The headless parts of a frame and a tick, run under the tracker after one warm-up step per mode (ARC builds its
+// placement table on the first step). Exits non-zero when a budget is exceeded, with budgets read from the file
+// given as the first argument (frame.leaderboard=0 and tick=0 by default).
+void runTicks(SnakeSim& sim, ReplayLog& replay, int ticks, std::mt19937& gen){
+    SNAKE_ALLOC_SCOPE(AllocTag::Sim);
+    for (int tick = 0; tick < ticks; tick++){
+        if (sim.youLose || sim.youWon){
+            sim.restart();
+            replay.begin(sim, gen());
+        }
+        for (std::size_t i = 0; i < sim.snakes.size(); i++){
+            sf::Vector2i head = sim.snakes[i].body.front();
+            std::uint8_t first = gen() % 4;
+            for (std::uint8_t offset = 0; offset < 4; offset++){
+                sf::Vector2i direction = SnakeSim::toDirection((first + offset) % 4);
+                sf::Vector2i next = head + direction;
+                if (sim.board.isInside(next) && !sim.board.isBlocked(next) && !sim.board.isOccupied(next)){
+                    if (sim.turn(static_cast<int>(i), direction)){
+                        SNAKE_ALLOC_SCOPE(AllocTag::Replay);
+                        replay.recordTurn(static_cast<int>(i), direction);
+                    }
+                    break;
+                }
+            }
+        }
+        replay.recordStep();
+        sim.step();
+        SNAKE_ALLOC_END_TICK();
+    }
+}
+
+int main(int argc, char* argv[]){
+    AllocTracker::Budget budget;
+    budget.perTick = 0, budget.perScreenFrame[3] = 0;
+    if (argc > 1 && !budget.load(argv[1])){
+        std::cerr << "Failed to read budget file " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::mt19937 gen(5);
+    std::vector<SnakeSim> sims(3, SnakeSim(11));
+    std::vector<ReplayLog> replays(3);
+    for (int mode = 0; mode < 3; mode++){
+        SnakeSim& sim = sims[mode];
+        sim.snakeCount = 2, sim.holeCount = 6;
+        sim.isCLSModeStarted = mode == 0, sim.isINFModeStarted = mode == 1, sim.isARCModeStarted = mode == 2;
+        sim.restart();
+        sim.step();
+        replays[mode].begin(sim, 11);
+    }
+    for (int mode = 0; mode < 3; mode++) runTicks(sims[mode], replays[mode], 50000, gen);
+
+    LeaderboardTable leaderboard;
+    leaderboard.reserve(100);
+    for (int i = 0; i < 100; i++) leaderboard.add("player_with_a_long_name_" + std::to_string(i), 100000 - i * 37);
+    std::string row;
+    row.reserve(64);
+    std::size_t checksum = 0;
+    {
+        SNAKE_ALLOC_SCOPE(AllocTag::Leaderboard);
+        for (int frame = 0; frame < 1000; frame++){
+            leaderboard.formatRows(row, [&](std::size_t, const std::string& text){ checksum += text.size(); });
+            SNAKE_ALLOC_END_FRAME(3);
+        }
+    }
+
+    std::uint64_t before = AllocTracker::threadAllocationCount();
+    for (std::size_t i = 0; i < leaderboard.size(); i++){
+        std::string concatenated = std::to_string(i + 1) + ". " + std::string(leaderboard[i].name) + " - " + std::to_string(leaderboard[i].score);
+        checksum += concatenated.size();
+    }
+    std::uint64_t concatenations = AllocTracker::threadAllocationCount() - before;
+
+    bool isWithinBudget = AllocTracker::report(std::cout, budget);
+    std::cout << "std::to_string concatenation for the same 100 rows: " << concatenations << " allocations per frame (checksum " << checksum << ")\n";
+    std::cout << (isWithinBudget ? "within budget\n" : "budget exceeded\n");
+    return isWithinBudget ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+#include "../asset_pack.h"
+#include <fstream>
+#include <chrono>
+#include <filesystem>
+
+template <typename Fn>
+double timeUs(int repeats, Fn&& fn){
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) fn();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+int main(int argc, char* argv[]){
+    std::filesystem::path root = argc > 1 ? argv[1] : "assets";
+    std::vector<AssetPack::Source> sources;
+    for (const auto& item : std::filesystem::recursive_directory_iterator(root)){
+        if (!item.is_regular_file()) continue;
+        std::ifstream in(item.path(), std::ios::binary);
+        sources.push_back({item.path().lexically_normal().generic_string(), std::vector<std::uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>())});
+    }
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "asset_load_bench.pack";
+    for (bool isCompressed : {false, true}){
+        std::vector<std::uint8_t> pack = AssetPack::build(sources, isCompressed);
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(pack.data()), static_cast<std::streamsize>(pack.size()));
+
+        std::size_t looseBytes = 0, packBytes = 0;
+        double looseUs = timeUs(20, [&]{
+            for (const AssetPack::Source& source : sources){
+                std::ifstream in(source.name, std::ios::binary);
+                std::vector<std::uint8_t> data(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>{});
+                looseBytes += data.size();
+            }
+        });
+        bool isIdentical = true;
+        double packUs = timeUs(20, [&]{
+            AssetPack assets;
+            assets.open(path.string());
+            for (const AssetPack::Source& source : sources){
+                std::span<const std::uint8_t> data = assets.view(source.name);
+                packBytes += data.size();
+                isIdentical = isIdentical && std::equal(data.begin(), data.end(), source.data.begin(), source.data.end());
+            }
+        });
+        std::cout << sources.size() << " assets, " << (isCompressed ? "compressed" : "stored") << " pack " << pack.size() / 1024 << " KiB\n";
+        std::cout << "  loose files " << looseUs << " us per full load, pack open + hash-checked views " << packUs << " us, contents "
+                  << (isIdentical && looseBytes == packBytes ? "identical" : "DIFFER") << "\n";
+    }
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,225 @@
+#include "../snake_batch.h"
+#include "../snake_sim.h"
+#include <chrono>
+
+const std::array<sf::Vector2i, 4> directions = {sf::Vector2i(0, -1), sf::Vector2i(0, 1), sf::Vector2i(-1, 0), sf::Vector2i(1, 0)};
+
+std::uint8_t cycleCode(sf::Vector2i pos, int width, int height){
+    if (pos.y == 0) return pos.x == 0 ? 1 : 2;
+    if (pos.x % 2 == 0) return pos.y == height - 1 ? 3 : 1;
+    if (pos.y == 1) return pos.x == width - 1 ? 0 : 3;
+    return 0;
+}
+
+std::uint8_t greedyCode(const SnakeSim& sim, std::mt19937& bot){
+    const Snake& snake = sim.snakes[0];
+    sf::Vector2i head = snake.body.front(), delta = sim.foodPos - head;
+    std::uint8_t best = SnakeSim::toCode(snake.direction);
+    int bestCost = 1 << 30;
+    for (std::uint8_t code = 0; code < 4; code++){
+        sf::Vector2i direction = directions[code], next = head + direction;
+        if (direction == -snake.direction) continue;
+        if (sim.isARCModeStarted) next = sf::Vector2i((next.x + sim.board.width) % sim.board.width, (next.y + sim.board.height) % sim.board.height);
+        bool isSafe = sim.board.isInside(next) && !sim.board.isOccupied(next) && !sim.board.isBlocked(next);
+        int cost = (isSafe ? 0 : 1 << 20) + std::abs(sim.foodPos.x - next.x) + std::abs(sim.foodPos.y - next.y) + static_cast<int>(bot() % 3);
+        if (delta == sf::Vector2i(0, 0)) cost = static_cast<int>(bot() % 4);
+        if (cost < bestCost) bestCost = cost, best = code;
+    }
+    return best;
+}
+
+template <typename Batch>
+bool sameState(const Batch& batch, std::size_t game, const SnakeSim& sim, bool isFull){
+    const Snake& snake = sim.snakes[0];
+    std::uint8_t expectedStatus = sim.youWon ? Batch::Won : sim.youLose ? Batch::Lost : Batch::Running;
+    if (batch.status[game] != expectedStatus || batch.gameScore[game] != sim.gameScore || batch.foodCell[game] != static_cast<std::int32_t>(sim.board.toCell(sim.foodPos)) ||
+        batch.bodyCount[game] != snake.body.size() || batch.freeCount[game] != sim.board.freeCellCount()) return false;
+    if (expectedStatus == Batch::Running && (batch.headX[game] != snake.body.front().x || batch.headY[game] != snake.body.front().y)) return false;
+    if (!isFull) return true;
+    for (std::size_t i = 0; i < snake.body.size(); i++){
+        if (batch.bodyAt(game, i) != sim.board.toCell(snake.body.at(i))) return false;
+    }
+    for (std::uint32_t cell = 0; cell < sim.board.cellCount(); cell++){
+        sf::Vector2i pos = sim.board.toPos(cell);
+        if (batch.isOccupied(game, cell) != sim.board.isOccupied(pos) || batch.isBlocked(game, cell) != sim.board.isBlocked(pos)) return false;
+    }
+    return true;
+}
+
+int differentialTest(std::uint8_t mode, bool useSimd, int gameCount, int ticks){
+    const int width = BoardGrid::minWidth, height = BoardGrid::minHeight;
+    SnakeBatch<std::mt19937> batch(gameCount, width, height, static_cast<SnakeBatch<std::mt19937>::Mode>(mode));
+    batch.useSimd = useSimd;
+    std::vector<SnakeSim> sims;
+    std::vector<std::uint32_t> seeds(gameCount);
+    std::mt19937 bot(mode * 7 + useSimd);
+    auto restart = [&](int game){
+        SnakeSim& sim = sims[game];
+        sim.reseed(seeds[game]);
+        sim.restart();
+        batch.reset(game, seeds[game]);
+        // ARC bots almost never reach 999 on the minimum board, so half of them start ten points short of it.
+        if (mode == 2 && game % 2 == 0) sim.gameScore = batch.gameScore[game] = ModeRules::arcadeWinScore - 10;
+    };
+    for (int game = 0; game < gameCount; game++){
+        SnakeSim& sim = sims.emplace_back(0);
+        sim.boardWidth = width, sim.boardHeight = height;
+        sim.isCLSModeStarted = mode == 0, sim.isINFModeStarted = mode == 1, sim.isARCModeStarted = mode == 2;
+        seeds[game] = 1000 + game;
+        restart(game);
+    }
+    int mismatches = 0, finished = 0, wins = 0, levels = 0, bestScore = 0;
+    for (int tick = 1; tick <= ticks && mismatches == 0; tick++){
+        for (int game = 0; game < gameCount; game++){
+            SnakeSim& sim = sims[game];
+            bool isCycle = mode != 2 && game % 4 == 0;
+            std::uint8_t code = isCycle ? cycleCode(sim.snakes[0].body.front(), width, height) : greedyCode(sim, bot);
+            if (!isCycle && bot() % 40 == 0) code = static_cast<std::uint8_t>(bot() % 4);
+            if (sim.turn(0, SnakeSim::toDirection(code)) != batch.turn(game, code)) mismatches++;
+            unsigned int levelCount = sim.levelCount;
+            sim.step();
+            levels += sim.levelCount != levelCount;
+        }
+        batch.step();
+        for (int game = 0; game < gameCount; game++){
+            SnakeSim& sim = sims[game];
+            bool isOver = sim.youLose || sim.youWon;
+            bestScore = std::max(bestScore, sim.gameScore);
+            if (!sameState(batch, game, sim, isOver || tick % 997 == 0)){
+                std::cerr << "  mismatch in game " << game << " at tick " << tick << "\n";
+                mismatches++;
+                break;
+            }
+            if (!isOver) continue;
+            finished++, wins += sim.youWon;
+            seeds[game] += gameCount;
+            restart(game);
+        }
+    }
+    const char* names[] = {"CLS", "INF", "ARC"};
+    std::cout << "  " << names[mode] << (useSimd ? " simd:   " : " scalar: ") << ticks << " ticks x " << gameCount << " games, " << finished << " finished, " << wins << " won, " << levels << " level resets, best score " << bestScore << ", "
+              << (mismatches ? "MISMATCH" : "identical to SnakeSim") << "\n";
+    return mismatches;
+}
+
+template <typename Step>
+double stepsPerSecond(std::size_t gameCount, int ticks, Step step){
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; tick++) step(tick);
+    return gameCount * static_cast<double>(ticks) / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void throughput(std::uint8_t mode, std::size_t gameCount, int ticks){
+    using Batch = SnakeBatch<>;
+    Batch batch(gameCount, BoardGrid::minWidth, BoardGrid::minHeight, static_cast<Batch::Mode>(mode));
+    std::vector<std::uint32_t> seeds(gameCount);
+    BatchRng bot;
+    bot.seed(mode);
+    auto runBatch = [&](int){
+        for (std::size_t game = 0; game < gameCount; game++){
+            if (batch.status[game] != Batch::Running) batch.reset(game, seeds[game] += static_cast<std::uint32_t>(gameCount));
+            int x = batch.headX[game] + batch.dirX[game], y = batch.headY[game] + batch.dirY[game];
+            if (x < 0 || y < 0 || x >= batch.width || y >= batch.height || bot() % 16 == 0) batch.turn(game, static_cast<std::uint8_t>(bot() % 4));
+        }
+        batch.step();
+    };
+    stepsPerSecond(gameCount, ticks / 10, runBatch);
+    double simd = stepsPerSecond(gameCount, ticks, runBatch);
+    batch.useSimd = false;
+    double scalar = stepsPerSecond(gameCount, ticks, runBatch);
+
+    std::vector<SnakeSim> sims;
+    sims.reserve(gameCount);
+    for (std::size_t game = 0; game < gameCount; game++){
+        SnakeSim& sim = sims.emplace_back(static_cast<std::uint32_t>(game));
+        sim.isCLSModeStarted = mode == 0, sim.isINFModeStarted = mode == 1, sim.isARCModeStarted = mode == 2;
+        sim.restart();
+    }
+    double single = stepsPerSecond(gameCount, ticks, [&](int){
+        for (SnakeSim& sim : sims){
+            if (sim.youLose || sim.youWon) sim.restart();
+            const Snake& snake = sim.snakes[0];
+            if (!sim.board.isInside(snake.body.front() + snake.direction) || bot() % 16 == 0) sim.turn(0, SnakeSim::toDirection(static_cast<std::uint8_t>(bot() % 4)));
+            sim.step();
+        }
+    });
+    const char* names[] = {"CLS", "INF", "ARC"};
+    std::cout << "  " << names[mode] << ": batch " << Batch::simdPath() << " " << simd / 1e6 << " M steps/s, batch scalar " << scalar / 1e6 << " M steps/s, SnakeSim "
+              << single / 1e6 << " M steps/s\n";
+}
+
+template <typename Bot, typename Step>
+double timedSteps(int ticks, Bot bot, Step step){
+    double seconds = 0;
+    for (int tick = 0; tick < ticks; tick++){
+        bot();
+        auto start = std::chrono::steady_clock::now();
+        step();
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return seconds;
+}
+
+int policyComparison(std::uint8_t mode, std::size_t gameCount, int ticks){
+    using Batch = SnakeBatch<>;
+    double batchSeconds[2], simSeconds[2];
+    long long checksums[4] = {};
+    for (int flagDriven = 0; flagDriven < 2; flagDriven++){
+        Batch batch(gameCount, BoardGrid::minWidth, BoardGrid::minHeight, static_cast<Batch::Mode>(mode));
+        std::vector<std::uint32_t> seeds(gameCount);
+        BatchRng bot;
+        bot.seed(mode);
+        batchSeconds[flagDriven] = timedSteps(ticks, [&]{
+            for (std::size_t game = 0; game < gameCount; game++){
+                if (batch.status[game] != Batch::Running) batch.reset(game, seeds[game] += static_cast<std::uint32_t>(gameCount));
+                int x = batch.headX[game] + batch.dirX[game], y = batch.headY[game] + batch.dirY[game];
+                if (x < 0 || y < 0 || x >= batch.width || y >= batch.height || bot() % 16 == 0) batch.turn(game, static_cast<std::uint8_t>(bot() % 4));
+            }
+        }, [&]{ flagDriven ? batch.stepFlagDriven() : batch.step(); });
+        for (std::size_t game = 0; game < gameCount; game++) checksums[flagDriven] += batch.gameScore[game] * 31 + batch.headX[game];
+
+        std::vector<SnakeSim> sims;
+        sims.reserve(gameCount);
+        for (std::size_t game = 0; game < gameCount; game++){
+            SnakeSim& sim = sims.emplace_back(static_cast<std::uint32_t>(game));
+            sim.isCLSModeStarted = mode == 0, sim.isINFModeStarted = mode == 1, sim.isARCModeStarted = mode == 2;
+            sim.restart();
+        }
+        bot.seed(mode);
+        simSeconds[flagDriven] = timedSteps(ticks, [&]{
+            for (SnakeSim& sim : sims){
+                if (sim.youLose || sim.youWon) sim.restart();
+                const Snake& snake = sim.snakes[0];
+                if (!sim.board.isInside(snake.body.front() + snake.direction) || bot() % 16 == 0) sim.turn(0, SnakeSim::toDirection(static_cast<std::uint8_t>(bot() % 4)));
+            }
+        }, [&]{
+            for (SnakeSim& sim : sims) flagDriven ? sim.stepFlagDriven() : sim.step();
+        });
+        for (const SnakeSim& sim : sims) checksums[2 + flagDriven] += sim.gameScore * 31 + sim.snakes[0].body.front().x;
+    }
+    const char* names[] = {"CLS", "INF", "ARC"};
+    bool isIdentical = checksums[0] == checksums[1] && checksums[2] == checksums[3];
+    double steps = static_cast<double>(gameCount) * ticks;
+    std::cout << "  " << names[mode] << ": batch " << batchSeconds[0] * 1e9 / steps << " ns/step specialized vs " << batchSeconds[1] * 1e9 / steps << " flag-driven, SnakeSim "
+              << simSeconds[0] * 1e9 / steps << " vs " << simSeconds[1] * 1e9 / steps << ", results "
+              << (isIdentical ? "identical" : "DIFFER") << "\n";
+    return isIdentical ? 0 : 1;
+}
+
+int main(int argc, char* argv[]){
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 400000;
+    std::size_t gameCount = argc > 2 ? std::atoi(argv[2]) : 4096;
+    std::cout << "Differential test against SnakeSim (" << BoardGrid::minWidth << "x" << BoardGrid::minHeight << ")\n";
+    int mismatches = 0;
+    for (std::uint8_t mode = 0; mode < 3; mode++){
+        for (bool useSimd : {true, false}) mismatches += differentialTest(mode, useSimd, 16, ticks);
+    }
+    if (mismatches) return 1;
+
+    SnakeBatch<> sizing(1, BoardGrid::minWidth, BoardGrid::minHeight, SnakeBatch<>::CLS);
+    std::cout << "Throughput, " << gameCount << " games, " << sizing.bytesPerGame() << " bytes/game in the batch vs " << sizeof(SnakeSim) << " + board and bodies per SnakeSim\n";
+    for (std::uint8_t mode = 0; mode < 3; mode++) throughput(mode, gameCount, 2000);
+    std::cout << "Mode policies, step time only\n";
+    for (std::uint8_t mode = 0; mode < 3; mode++) mismatches += policyComparison(mode, gameCount, 2000);
+    return mismatches ? 1 : 0;
+}
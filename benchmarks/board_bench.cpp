@@ -0,0 +1,72 @@
+#include "../snake_board.h"
+#include <iostream>
+#include <chrono>
+#include <random>
+
+double tickBench(int width, int height, std::size_t length, int ticks){
+    BoardGrid board;
+    board.resize(width, height);
+    SnakeBody snakeBody(board);
+    snakeBody.resize();
+    sf::Vector2i pos(0, 0), direction(1, 0);
+    for (std::size_t i = 0; i < length; i++){
+        snakeBody.pushFront(pos);
+        pos.x++;
+        if (pos.x == board.width) pos.x = 0, pos.y = (pos.y + 1) % board.height;
+    }
+    std::mt19937 gen(1);
+    sf::Vector2i foodPos;
+    std::size_t collisions = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ticks; i++){
+        sf::Vector2i next = snakeBody.front() + direction;
+        next = sf::Vector2i((next.x + board.width) % board.width, (next.y + board.height) % board.height);
+        snakeBody.popBack();
+        collisions += board.isOccupied(next);
+        snakeBody.pushFront(next);
+        if (i % 8 == 0) board.randomFreeCell(gen, foodPos);
+        if (i % 64 == 0) direction = direction.x ? sf::Vector2i(0, 1) : sf::Vector2i(1, 0);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ticks;
+    if (collisions == std::size_t(-1)) std::cout << foodPos.x;
+    return ns;
+}
+
+double spawnBench(int width, int height, double fill, int spawns, bool useFreeList){
+    BoardGrid board;
+    board.resize(width, height);
+    SnakeBody snakeBody(board);
+    snakeBody.resize();
+    std::size_t length = static_cast<std::size_t>(board.cellCount() * fill);
+    for (std::size_t cell = 0; cell < length; cell++) snakeBody.pushBack(board.toPos(static_cast<std::uint32_t>(cell)));
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<int> distX(0, board.width - 1), distY(0, board.height - 1);
+    sf::Vector2i foodPos;
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < spawns; i++){
+        if (useFreeList) board.randomFreeCell(gen, foodPos);
+        else {
+            do foodPos = sf::Vector2i(distX(gen), distY(gen));
+            while (board.isOccupied(foodPos));
+        }
+        checksum += foodPos.x;
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / spawns;
+    if (checksum == -1) std::cout << checksum;
+    return ns;
+}
+
+int main(){
+    const int sizes[][2] = {{42, 19}, {200, 200}, {1000, 1000}};
+    for (auto& size : sizes){
+        std::size_t cells = static_cast<std::size_t>(size[0]) * size[1];
+        std::cout << size[0] << "x" << size[1] << "\n";
+        std::cout << "  tick, length 10%:     " << tickBench(size[0], size[1], cells / 10, 1000000) << " ns\n";
+        std::cout << "  tick, length 90%:     " << tickBench(size[0], size[1], cells * 9 / 10, 1000000) << " ns\n";
+        for (double fill : {0.5, 0.99}){
+            std::cout << "  spawn, " << fill * 100 << "% full: free list " << spawnBench(size[0], size[1], fill, 100000, true)
+                      << " ns, rejection " << spawnBench(size[0], size[1], fill, fill > 0.9 ? 2000 : 100000, false) << " ns\n";
+        }
+    }
+}
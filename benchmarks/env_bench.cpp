@@ -0,0 +1,56 @@
+#include "../snake_env.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <random>
+
+double envStepsPerSecond(int mode, int envCount, int threadCount, int steps, bool withObservations){
+    SnakeEnvConfig config;
+    snake_env_default_config(&config);
+    config.mode = mode, config.envCount = envCount, config.threadCount = threadCount, config.seed = 7, config.maxTicks = 5000;
+    SnakeEnv* env = snake_env_create(&config);
+    if (!env) return 0;
+    int32_t count, height, width;
+    snake_env_shape(env, &count, &height, &width);
+    std::vector<std::uint8_t> observations(withObservations ? static_cast<std::size_t>(count) * height * width : 0), status(count);
+    std::vector<float> rewards(count);
+    std::vector<std::int32_t> scores(count);
+    std::vector<std::vector<std::uint8_t>> actions(64, std::vector<std::uint8_t>(count));
+    std::mt19937 gen(1);
+    for (auto& batch : actions){
+        for (std::uint8_t& action : batch) action = gen() % 8 < 2 ? static_cast<std::uint8_t>(gen() % 4) : std::uint8_t{SNAKE_ENV_NOOP};
+    }
+    std::uint8_t* observationData = withObservations ? observations.data() : nullptr;
+    snake_env_reset(env, nullptr, observationData);
+    for (int i = 0; i < steps / 10; i++) snake_env_step(env, actions[i % actions.size()].data(), observationData, rewards.data(), status.data(), scores.data());
+    std::uint64_t episodes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; i++){
+        snake_env_step(env, actions[i % actions.size()].data(), observationData, rewards.data(), status.data(), scores.data());
+        for (std::uint8_t result : status) episodes += result != SNAKE_ENV_RUNNING;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    snake_env_destroy(env);
+    if (episodes == 0) std::cout << "  no episode finished\n";
+    return static_cast<double>(count) * steps / seconds;
+}
+
+int main(int argc, char* argv[]){
+    int envCount = argc > 1 ? std::atoi(argv[1]) : 4096;
+    int steps = argc > 2 ? std::atoi(argv[2]) : 1000;
+    if (snake_env_abi_version() != SNAKE_ENV_ABI_VERSION){
+        std::cerr << "Library ABI " << snake_env_abi_version() << " does not match header ABI " << SNAKE_ENV_ABI_VERSION << "\n";
+        return 1;
+    }
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const char* names[] = {"CLS", "INF", "ARC"};
+    for (int mode = SNAKE_ENV_CLS; mode <= SNAKE_ENV_ARC; mode++){
+        std::cout << names[mode] << ", " << envCount << " envs\n";
+        for (int threads = 1; threads <= maxThreads; threads *= 2){
+            std::cout << "  " << threads << " thread(s): " << envStepsPerSecond(mode, envCount, threads, steps, true) / 1e6 << " M env-steps/s with observations, "
+                      << envStepsPerSecond(mode, envCount, threads, steps, false) / 1e6 << " M without\n";
+            if (threads < maxThreads && threads * 2 > maxThreads) threads = maxThreads / 2;
+        }
+    }
+}
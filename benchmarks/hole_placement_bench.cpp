@@ -0,0 +1,106 @@
+#include "../hole_placement.h"
+#include <iostream>
+#include <chrono>
+#include <map>
+#include <cmath>
+
+struct Scenario {
+    const char* name;
+    int width, height;
+    std::vector<HoleShape> shapes;
+};
+
+struct SpawnStats {
+    double meanNs = 0, maxNs = 0, meanAttempts = 0;
+    long long maxAttempts = 0, failures = 0;
+};
+
+bool overlaps(sf::Vector2i a, HoleShape aShape, sf::Vector2i b, HoleShape bShape){
+    return a.x < b.x + bShape.width && b.x < a.x + aShape.width && a.y < b.y + bShape.height && b.y < a.y + aShape.height;
+}
+
+long long rejectionSpawn(const Scenario& scenario, sf::Vector2i spawn, std::mt19937& gen, std::vector<sf::Vector2i>& holes, long long maxAttempts){
+    std::size_t count = scenario.shapes.size();
+    holes.resize(count);
+    for (long long attempt = 1; attempt <= maxAttempts; attempt++){
+        bool isValid = true;
+        for (std::size_t i = 0; i < count; i++){
+            const HoleShape& shape = scenario.shapes[i];
+            holes[i] = sf::Vector2i(std::uniform_int_distribution<int>(0, scenario.width - shape.width)(gen), std::uniform_int_distribution<int>(0, scenario.height - shape.height)(gen));
+            isValid = isValid && !overlaps(holes[i], shape, spawn, HoleShape{1, 1});
+            for (std::size_t j = 0; j < i && isValid; j++) isValid = !overlaps(holes[i], shape, holes[j], scenario.shapes[j]);
+        }
+        if (isValid) return attempt;
+    }
+    return -1;
+}
+
+template <typename Spawn>
+SpawnStats measure(int spawns, Spawn&& spawn){
+    SpawnStats stats;
+    for (int i = 0; i < spawns; i++){
+        auto start = std::chrono::steady_clock::now();
+        long long attempts = spawn();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        stats.meanNs += ns / spawns, stats.maxNs = std::max(stats.maxNs, ns);
+        if (attempts < 0) stats.failures++;
+        else stats.meanAttempts += static_cast<double>(attempts) / spawns, stats.maxAttempts = std::max(stats.maxAttempts, attempts);
+    }
+    return stats;
+}
+
+double uniformityDistance(const std::map<std::pair<int, int>, long long>& counts, std::uint64_t pairCount, long long samples){
+    double distance = static_cast<double>(pairCount - counts.size()) / pairCount;
+    for (const auto& [pair, count] : counts) distance += std::abs(static_cast<double>(count) / samples - 1.0 / pairCount);
+    return distance / 2;
+}
+
+int main(){
+    const std::vector<Scenario> scenarios = {
+        {"42x19, 2 holes 6x6", 42, 19, {{6, 6}, {6, 6}}},
+        {"42x19, 5 holes 6x6", 42, 19, std::vector<HoleShape>(5, HoleShape{6, 6})},
+        {"42x19, 8 holes 6x6", 42, 19, std::vector<HoleShape>(8, HoleShape{6, 6})},
+        {"42x19, mixed 6x6 4x8 10x3 3x3 2x12", 42, 19, {{6, 6}, {4, 8}, {10, 3}, {3, 3}, {2, 12}}},
+        {"200x200, 16 holes 6x6", 200, 200, std::vector<HoleShape>(16, HoleShape{6, 6})},
+    };
+    const long long attemptCap = 1 << 20;
+    for (const Scenario& scenario : scenarios){
+        sf::Vector2i spawn(scenario.width / 2 - 1, scenario.height / 2);
+        auto start = std::chrono::steady_clock::now();
+        HolePlacer placer(scenario.width, scenario.height, scenario.shapes, {spawn});
+        double buildUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        std::mt19937 gen(1);
+        std::vector<sf::Vector2i> holes(scenario.shapes.size());
+        long long placedTotal = 0;
+        int spawns = 20000;
+        SpawnStats table = measure(spawns, [&]{
+            int placed = placer.sample(gen, std::span(holes));
+            placedTotal += placed;
+            return placed == static_cast<int>(holes.size()) ? 1LL : -1LL;
+        });
+        SpawnStats rejection = measure(scenario.shapes.size() > 5 && scenario.width < 100 ? 20 : spawns, [&]{ return rejectionSpawn(scenario, spawn, gen, holes, attemptCap); });
+
+        std::cout << scenario.name << ", table built in " << buildUs << " us\n";
+        std::cout << "  table:     mean " << table.meanNs << " ns, worst " << table.maxNs << " ns, " << static_cast<double>(placedTotal) / spawns << " holes placed on average\n";
+        std::cout << "  rejection: mean " << rejection.meanNs << " ns, worst " << rejection.maxNs << " ns, " << rejection.meanAttempts << " attempts on average, worst " << rejection.maxAttempts;
+        if (rejection.failures) std::cout << ", " << rejection.failures << " gave up after " << attemptCap << " attempts";
+        std::cout << "\n";
+    }
+
+    Scenario small{"16x10, 2 holes 6x6", 16, 10, {{6, 6}, {6, 6}}};
+    sf::Vector2i spawn(small.width / 2 - 1, small.height / 2);
+    HolePlacer placer(small.width, small.height, small.shapes, {spawn});
+    std::map<std::pair<int, int>, long long> tableCounts, rejectionCounts;
+    std::mt19937 gen(2);
+    std::vector<sf::Vector2i> holes(2);
+    const long long samples = 2000000;
+    for (long long i = 0; i < samples; i++){
+        placer.sample(gen, std::span(holes));
+        tableCounts[{holes[0].y * small.width + holes[0].x, holes[1].y * small.width + holes[1].x}]++;
+        rejectionSpawn(small, spawn, gen, holes, attemptCap);
+        rejectionCounts[{holes[0].y * small.width + holes[0].x, holes[1].y * small.width + holes[1].x}]++;
+    }
+    std::cout << small.name << ": " << placer.pairCount() << " valid ordered pairs, total variation from uniform over " << samples << " samples: table "
+              << uniformityDistance(tableCounts, placer.pairCount(), samples) << ", rejection " << uniformityDistance(rejectionCounts, placer.pairCount(), samples) << "\n";
+}
@@ -0,0 +1,118 @@
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#define CPPHTTPLIB_ZLIB_SUPPORT
+#define CPPHTTPLIB_BROTLI_SUPPORT
+#include "../include/httplib.h"
+#include "../snake_replay.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+struct EndpointLatency {
+    std::vector<double> samples;
+    std::uint64_t failures = 0;
+
+    void merge(const EndpointLatency& other){
+        samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+        failures += other.failures;
+    }
+
+    void print(const std::string& name, double seconds){
+        if (samples.empty()) return;
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&](double p){ return samples[static_cast<std::size_t>(p * (samples.size() - 1))]; };
+        std::cout << "  " << name << ": " << samples.size() << " requests, " << samples.size() / seconds << " req/s, p50 " << percentile(0.5) << " ms, p95 "
+                  << percentile(0.95) << " ms, p99 " << percentile(0.99) << " ms, max " << samples.back() << " ms, " << failures << " failed\n";
+    }
+};
+
+std::vector<std::uint8_t> shortReplay(std::uint32_t seed, int& score){
+    SnakeSim sim(seed);
+    sim.isINFModeStarted = true;
+    sim.reseed(seed);
+    sim.restart();
+    ReplayLog replay;
+    replay.begin(sim, seed);
+    while (!sim.youLose){
+        replay.recordStep();
+        sim.step();
+    }
+    score = replay.score = sim.gameScore;
+    return replay.compress();
+}
+
+template <typename Request>
+bool timed(EndpointLatency& latency, Request request){
+    auto start = std::chrono::steady_clock::now();
+    httplib::Result result = request();
+    latency.samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    bool ok = result && (result->status == 200 || result->status == 304);
+    if (!ok) latency.failures++;
+    return ok;
+}
+
+int main(int argc, char* argv[]){
+    std::string url = "https://localhost:8080", caPath = "server-cert.pem";
+    int playerCount = 16, durationSeconds = 10;
+    for (int i = 1; i + 1 < argc; i += 2){
+        std::string arg = argv[i];
+        if (arg == "--url") url = argv[i + 1];
+        else if (arg == "--ca") caPath = argv[i + 1];
+        else if (arg == "--players") playerCount = std::max(1, std::atoi(argv[i + 1]));
+        else if (arg == "--seconds") durationSeconds = std::max(1, std::atoi(argv[i + 1]));
+    }
+
+    std::string runId = std::to_string(std::chrono::system_clock::now().time_since_epoch().count() % 1000000);
+    EndpointLatency registerTotal, loginTotal, leaderboardTotal, scoreTotal;
+    std::mutex totalsMutex;
+    std::atomic<bool> isRunning{true};
+    std::vector<std::thread> players;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < playerCount; i++){
+        players.emplace_back([&, i]{
+            httplib::Client client(url);
+            client.set_ca_cert_path(caPath);
+            client.set_keep_alive(true);
+            client.set_default_headers({{"Content-Type", "application/json"}});
+            EndpointLatency registerLatency, loginLatency, leaderboardLatency, scoreLatency;
+            std::string username = "load_" + runId + "_" + std::to_string(i), password = "password" + std::to_string(i), token;
+            nlohmann::json credentials = {{"username", username}, {"password", password}};
+            timed(registerLatency, [&]{ return client.Post("/register", credentials.dump(), "application/json"); });
+            timed(loginLatency, [&]{
+                httplib::Result result = client.Post("/login", credentials.dump(), "application/json");
+                if (result && result->status == 200) token = nlohmann::json::parse(result->body, nullptr, false).value("token", "");
+                return result;
+            });
+            httplib::Headers headers = {{"Authorization", "Bearer " + token}};
+            std::string etag;
+            std::uint32_t seed = static_cast<std::uint32_t>(i) * 7919;
+            while (isRunning){
+                timed(leaderboardLatency, [&]{
+                    httplib::Headers conditional = headers;
+                    if (!etag.empty()) conditional.emplace("If-None-Match", etag);
+                    httplib::Result result = client.Get("/leaderboard", conditional);
+                    if (result && result->status == 200) etag = result->get_header_value("ETag");
+                    return result;
+                });
+                int score;
+                std::vector<std::uint8_t> replay = shortReplay(seed++, score);
+                nlohmann::json body = {{"score", score}, {"replay", ReplayLog::toBase64(replay)}};
+                timed(scoreLatency, [&]{ return client.Post("/update_user_score", headers, body.dump(), "application/json"); });
+            }
+            std::lock_guard lock(totalsMutex);
+            registerTotal.merge(registerLatency), loginTotal.merge(loginLatency), leaderboardTotal.merge(leaderboardLatency), scoreTotal.merge(scoreLatency);
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(durationSeconds));
+    isRunning = false;
+    for (std::thread& player : players) player.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << playerCount << " players for " << seconds << " s against " << url << "\n";
+    registerTotal.print("/register", seconds);
+    loginTotal.print("/login", seconds);
+    leaderboardTotal.print("/leaderboard", seconds);
+    scoreTotal.print("/update_user_score", seconds);
+    std::cout << "  total: " << (leaderboardTotal.samples.size() + scoreTotal.samples.size()) / seconds << " req/s in the play loop\n";
+}
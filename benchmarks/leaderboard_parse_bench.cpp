@@ -0,0 +1,125 @@
+#include "../leaderboard_table.h"
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::size_t liveBytes = 0, peakBytes = 0;
+    constexpr std::size_t headerSize = alignof(std::max_align_t);
+}
+
+void* operator new(std::size_t size){
+    void* block = std::malloc(size + headerSize);
+    if (!block) throw std::bad_alloc();
+    *static_cast<std::size_t*>(block) = size;
+    liveBytes += size;
+    peakBytes = std::max(peakBytes, liveBytes);
+    return static_cast<char*>(block) + headerSize;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    void* block = static_cast<char*>(pointer) - headerSize;
+    liveBytes -= *static_cast<std::size_t*>(block);
+    std::free(block);
+}
+
+void* operator new[](std::size_t size){ return operator new(size); }
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { operator delete(pointer); }
+
+std::string makePayload(int entryCount, int repeatedNames, std::uint32_t seed){
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> scores(0, 5000);
+    std::string body = "[";
+    body.reserve(static_cast<std::size_t>(entryCount) * 48);
+    for (int i = 0; i < entryCount; i++){
+        if (i > 0) body += ',';
+        int nameId = repeatedNames > 0 ? i % repeatedNames : i;
+        body += "{\"highscore\":" + std::to_string(scores(rng)) + ",\"username\":\"player_" + std::to_string(nameId) + "\"}";
+    }
+    body += "]";
+    return body;
+}
+
+bool parseDom(const std::string& body, std::vector<std::pair<std::string, int>>& leaderboard){
+    try {
+        nlohmann::json jsonResponse = nlohmann::json::parse(body);
+        leaderboard.clear();
+        for (const auto& entry : jsonResponse){
+            std::string username = entry["username"];
+            int score = entry["highscore"];
+            if (score == 0) continue;
+            leaderboard.emplace_back(username, score);
+        }
+        std::sort(leaderboard.begin(), leaderboard.end(), [](const auto& a, const auto& b){ return a.second > b.second; });
+        return true;
+    } catch (const std::exception& e){
+        std::cerr << "Failed to parse JSON: " << e.what() << '\n';
+        return false;
+    }
+}
+
+struct Measurement {
+    double bestMs = 1e300;
+    std::size_t peakBytes = 0, retainedBytes = 0;
+};
+
+template <typename Parse>
+Measurement measure(int runs, Parse parse){
+    Measurement result;
+    for (int run = 0; run < runs; run++){
+        std::size_t baseline = liveBytes;
+        peakBytes = liveBytes;
+        auto start = std::chrono::steady_clock::now();
+        std::size_t retained = parse();
+        result.bestMs = std::min(result.bestMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        result.peakBytes = std::max(result.peakBytes, peakBytes - baseline);
+        result.retainedBytes = retained;
+    }
+    return result;
+}
+
+void print(const char* name, const Measurement& measurement, std::size_t payloadBytes){
+    std::cout << "  " << name << ": " << measurement.bestMs << " ms (" << payloadBytes / 1e6 / (measurement.bestMs / 1000.0) << " MB/s), peak heap "
+              << measurement.peakBytes / 1024 << " KiB, retained " << measurement.retainedBytes / 1024 << " KiB\n";
+}
+
+int main(int argc, char* argv[]){
+    int entryCount = 100000, runs = 10;
+    if (argc > 1) entryCount = std::max(1, std::atoi(argv[1]));
+    if (argc > 2) runs = std::max(1, std::atoi(argv[2]));
+
+    for (int repeatedNames : {0, 1000}){
+        std::string body = makePayload(entryCount, repeatedNames, 42);
+        std::cout << entryCount << " entries, " << (repeatedNames ? std::to_string(repeatedNames) + " distinct names" : std::string("unique names")) << ", "
+                  << body.size() / 1024 << " KiB payload\n";
+
+        std::vector<std::pair<std::string, int>> dom;
+        Measurement domResult = measure(runs, [&]{
+            std::size_t before = liveBytes;
+            std::vector<std::pair<std::string, int>>().swap(dom);
+            std::size_t released = before - liveBytes;
+            parseDom(body, dom);
+            return liveBytes - before + released;
+        });
+
+        LeaderboardTable table;
+        Measurement saxResult = measure(runs, [&]{
+            std::size_t before = liveBytes;
+            table = LeaderboardTable();
+            std::size_t released = before - liveBytes;
+            table.parse(body);
+            return liveBytes - before + released;
+        });
+
+        bool isEqual = dom.size() == table.size();
+        for (std::size_t i = 0; isEqual && i < dom.size(); i++) isEqual = dom[i].second == table[i].score;
+        print("DOM + vector<pair<string, int>>", domResult, body.size());
+        print("SAX + interned table", saxResult, body.size());
+        std::cout << "  " << table.size() << " rows, " << table.uniqueNames() << " interned names, results " << (isEqual ? "match" : "DIFFER") << "\n";
+        if (!isEqual) return 1;
+    }
+}
@@ -0,0 +1,89 @@
+#include "../snake_sim.h"
+#include <fstream>
+#include <chrono>
+#include <filesystem>
+
+LevelLayout randomLayout(int width, int height, double density, std::uint32_t seed){
+    LevelLayout layout;
+    layout.name = "random " + std::to_string(width) + "x" + std::to_string(height);
+    layout.width = width, layout.height = height;
+    layout.obstacles.assign(static_cast<std::size_t>(width) * height, 0);
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution isObstacle(density);
+    for (std::uint8_t& cell : layout.obstacles) cell = isObstacle(gen);
+    layout.obstacles[(height / 2) * width + width / 2] = 0;
+    layout.spawns.push_back(LevelSpawn{static_cast<std::uint16_t>(width / 2), static_cast<std::uint16_t>(height / 2), 3, {}});
+    return layout;
+}
+
+template <typename Fn>
+double timeUs(int repeats, Fn&& fn){
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) fn();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+bool sameBoard(const BoardGrid& a, const BoardGrid& b){
+    if (a.width != b.width || a.height != b.height || a.freeCellCount() != b.freeCellCount() || a.openCellCount() != b.openCellCount()) return false;
+    for (int y = 0; y < a.height; y++){
+        for (int x = 0; x < a.width; x++){
+            if (a.isBlocked(sf::Vector2i(x, y)) != b.isBlocked(sf::Vector2i(x, y))) return false;
+        }
+    }
+    return true;
+}
+
+int main(){
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "level_load_bench.pack";
+    for (int size : {42, 200, 1000}){
+        int height = size == 42 ? 19 : size;
+        LevelLayout layout = randomLayout(size, height, 0.2, 7);
+        LevelLayout zoned = layout;
+        zoned.zones.push_back(LevelZone{0, 0, static_cast<std::uint16_t>(size / 2), static_cast<std::uint16_t>(height)});
+        std::vector<std::uint8_t> pack = LevelPack::build({layout.encode(), zoned.encode()});
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(pack.data()), static_cast<std::streamsize>(pack.size()));
+
+        int repeats = size == 1000 ? 20 : 2000;
+        LevelPack levels;
+        double openUs = timeUs(repeats, [&]{ levels = LevelPack(); levels.open(path.string()); });
+        double firstLoadUs = timeUs(repeats, [&]{ levels = LevelPack(); levels.open(path.string()); levels.load(0); }) - openUs;
+        BoardGrid loaded;
+        loaded.resize(size, height);
+        double applyUs = timeUs(repeats, [&]{ levels[0].applyTo(loaded); });
+
+        BoardGrid stamped;
+        stamped.resize(size, height);
+        double stampUs = timeUs(repeats, [&]{
+            stamped.reset();
+            for (int y = 0; y < height; y++){
+                for (int x = 0; x < size; x++){
+                    if (layout.obstacles[y * size + x]) stamped.block(sf::Vector2i(x, y));
+                }
+            }
+        });
+
+        SnakeSim sim(1);
+        sim.level = levels.load(1);
+        sim.isCLSModeStarted = true;
+        sim.restart();
+        int ticks = 0;
+        while (!sim.youLose && !sim.youWon && ticks < 100000){
+            sf::Vector2i head = sim.snakes[0].body.front();
+            for (std::uint8_t code = 0; code < 4; code++){
+                sf::Vector2i next = head + SnakeSim::toDirection(code);
+                if (sim.board.isInside(next) && !sim.board.isBlocked(next) && !sim.board.isOccupied(next)){
+                    sim.turn(0, SnakeSim::toDirection(code));
+                    break;
+                }
+            }
+            sim.step();
+            ticks++;
+        }
+        bool isFoodInZone = sim.foodPos.x < size / 2;
+
+        std::cout << size << "x" << height << ", " << pack.size() / 1024 << " KiB pack\n";
+        std::cout << "  map pack " << openUs << " us, first load check " << firstLoadUs << " us, apply precomputed layout " << applyUs << " us, stamp obstacles cell by cell " << stampUs << " us\n";
+        std::cout << "  boards " << (sameBoard(loaded, stamped) ? "identical" : "DIFFER") << ", sim ran " << ticks << " ticks, food " << (isFoodInZone ? "inside" : "OUTSIDE") << " its zone\n";
+    }
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,90 @@
+#include "../snake_replay.h"
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+
+std::vector<std::uint8_t> playReplay(std::uint32_t seed, int width, int height, int& score, std::uint32_t& ticks){
+    SnakeSim sim(seed);
+    sim.boardWidth = width, sim.boardHeight = height, sim.isINFModeStarted = true;
+    sim.reseed(seed);
+    sim.restart();
+    ReplayLog replay;
+    replay.begin(sim, seed);
+    std::mt19937 bot(seed ^ 0x5eed);
+    const std::array<sf::Vector2i, 4> directions = {sf::Vector2i(0, -1), sf::Vector2i(0, 1), sf::Vector2i(-1, 0), sf::Vector2i(1, 0)};
+    while (!sim.youLose && !sim.youWon && replay.tickCount < 20000){
+        const Snake& snake = sim.snakes[0];
+        sf::Vector2i head = snake.body.front(), want = snake.direction;
+        if (bot() % 50 == 0) want = directions[bot() % 4];
+        else {
+            sf::Vector2i delta = sim.foodPos - head;
+            if (delta.x != 0 && snake.direction.x == 0) want = sf::Vector2i(delta.x > 0 ? 1 : -1, 0);
+            else if (delta.y != 0 && snake.direction.y == 0) want = sf::Vector2i(0, delta.y > 0 ? 1 : -1);
+            sf::Vector2i next = head + want;
+            if (!sim.board.isInside(next) || sim.board.isOccupied(next)){
+                for (sf::Vector2i direction : directions){
+                    next = head + direction;
+                    if (direction != -snake.direction && sim.board.isInside(next) && !sim.board.isOccupied(next)) want = direction;
+                }
+            }
+        }
+        if (want != snake.direction && sim.turn(0, want)) replay.recordTurn(0, want);
+        replay.recordStep();
+        sim.step();
+    }
+    score = replay.score = sim.gameScore;
+    ticks = replay.tickCount;
+    return replay.compress();
+}
+
+int main(int argc, char* argv[]){
+    int replayCount = argc > 1 ? std::atoi(argv[1]) : 2000;
+    unsigned threadCount = argc > 2 ? std::atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    bool isFailed = false;
+    for (auto size : {std::array<int, 2>{42, 19}, std::array<int, 2>{100, 100}}){
+        std::vector<std::vector<std::uint8_t>> replays;
+        std::uint64_t totalTicks = 0, totalBytes = 0;
+        double totalScore = 0;
+        for (int i = 0; i < replayCount; i++){
+            int score;
+            std::uint32_t ticks;
+            replays.push_back(playReplay(1000 + i, size[0], size[1], score, ticks));
+            totalTicks += ticks, totalBytes += replays.back().size(), totalScore += score;
+        }
+        std::cout << size[0] << "x" << size[1] << ": " << replayCount << " replays, avg " << totalTicks / replayCount << " ticks, score " << totalScore / replayCount
+                  << ", " << totalBytes / replayCount << " bytes compressed\n";
+
+        ReplayVerifier verifier;
+        int accepted = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const std::vector<std::uint8_t>& data : replays) accepted += verifier.verify(data.data(), data.size()) == ReplayVerifier::Accepted;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  1 thread: " << accepted << "/" << replayCount << " accepted, " << replayCount / seconds << " replays/s, " << totalTicks / seconds / 1e6 << " M ticks/s\n";
+
+        std::vector<std::thread> threads;
+        std::atomic<int> parallelAccepted{0};
+        start = std::chrono::steady_clock::now();
+        for (unsigned t = 0; t < threadCount; t++){
+            threads.emplace_back([&, t]{
+                ReplayVerifier worker;
+                for (std::size_t i = t; i < replays.size(); i += threadCount) parallelAccepted += worker.verify(replays[i].data(), replays[i].size()) == ReplayVerifier::Accepted;
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  " << threadCount << " threads: " << parallelAccepted << "/" << replayCount << " accepted, " << replayCount / seconds << " replays/s\n";
+
+        int rejected = 0;
+        ReplayLog forged;
+        for (const std::vector<std::uint8_t>& data : replays){
+            forged.decompress(data.data(), data.size());
+            forged.score += 5;
+            std::vector<std::uint8_t> forgedData = forged.compress();
+            rejected += verifier.verify(forgedData.data(), forgedData.size()) == ReplayVerifier::ScoreMismatch;
+        }
+        std::cout << "  forged scores rejected: " << rejected << "/" << replayCount << "\n";
+        isFailed = isFailed || accepted != replayCount || parallelAccepted != replayCount || rejected != replayCount;
+    }
+    return isFailed ? 1 : 0;
+}
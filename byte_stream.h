@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class ByteWriter {
+    public:
+    std::vector<std::uint8_t> bytes;
+
+    void u8(std::uint8_t value){
+        bytes.push_back(value);
+    }
+
+    void varint(std::uint32_t value){
+        while (value >= 0x80){
+            bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    void codes(const std::vector<std::uint8_t>& values){
+        for (std::size_t i = 0; i < values.size(); i += 4){
+            std::uint8_t packed = 0;
+            for (std::size_t k = 0; k < 4 && i + k < values.size(); k++) packed |= values[i + k] << (k * 2);
+            bytes.push_back(packed);
+        }
+    }
+
+    void clear(){ bytes.clear(); }
+};
+
+class ByteReader {
+    public:
+    const std::uint8_t* data;
+    std::size_t size, offset;
+    bool isValid;
+
+    ByteReader(const void* data, std::size_t size) : data{static_cast<const std::uint8_t*>(data)}, size{size}, offset{0}, isValid{true} {}
+
+    std::uint8_t u8(){
+        if (offset >= size){
+            isValid = false;
+            return 0;
+        }
+        return data[offset++];
+    }
+
+    std::uint32_t varint(){
+        std::uint32_t value = 0;
+        for (int shift = 0; shift < 35 && isValid; shift += 7){
+            std::uint8_t byte = u8();
+            value |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        isValid = false;
+        return 0;
+    }
+
+    void codes(std::vector<std::uint8_t>& values, std::size_t count){
+        values.resize(count);
+        for (std::size_t i = 0; i < count; i += 4){
+            std::uint8_t packed = u8();
+            for (std::size_t k = 0; k < 4 && i + k < count; k++) values[i + k] = (packed >> (k * 2)) & 3;
+        }
+    }
+};
@@ -0,0 +1,273 @@
+#include "net_protocol.h"
+#include <cstring>
+#include <csignal>
+#include <atomic>
+#include <thread>
+#include <random>
+
+std::atomic<bool> isRunning{true};
+
+struct Player {
+    sf::IpAddress address;
+    unsigned short port;
+    int snakeIndex;
+    std::uint32_t ackTick, echoMs;
+    std::uint8_t lateCode;
+    std::array<std::uint32_t, NetProtocol::historySize> inputTicks{};
+    std::array<std::uint8_t, NetProtocol::historySize> inputCodes{};
+    std::chrono::steady_clock::time_point lastHeard{};
+};
+
+class GameServer {
+    public:
+    sf::UdpSocket socket;
+    LatencySimulator outgoing;
+    SnakeSim sim;
+    std::vector<Player> players;
+    std::array<NetBaseline, NetProtocol::historySize> history;
+    std::uint32_t tick;
+    int moveIntervalMs, maxSpectators;
+    std::uint64_t stateBytes, statePackets, fullStates, statsBytes, statsPackets;
+
+    GameServer() : outgoing{socket}, tick{0}, moveIntervalMs{240}, maxSpectators{8}, stateBytes{0}, statePackets{0}, fullStates{0}, statsBytes{0}, statsPackets{0}, nonceKey{std::random_device{}() | std::uint64_t(std::random_device{}()) << 32} {}
+
+    bool start(unsigned short port){
+        if (socket.bind(port) != sf::Socket::Done){
+            std::cerr << "Failed to bind game server to port " << port << "\n";
+            return false;
+        }
+        socket.setBlocking(false);
+        sim.restart();
+        history[0] = NetBaseline::capture(sim, 0);
+        std::cout << "Game server listening on port " << port << ", " << sim.board.width << "x" << sim.board.height << ", " << sim.snakeCount
+                  << " snake(s), tick " << moveIntervalMs << " ms\n";
+        return true;
+    }
+
+    void run(){
+        auto interval = std::chrono::milliseconds(moveIntervalMs);
+        auto nextTick = std::chrono::steady_clock::now() + interval;
+        auto nextStats = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (isRunning){
+            receive();
+            auto now = std::chrono::steady_clock::now();
+            if (now >= nextTick){
+                nextTick += interval;
+                step();
+            }
+            if (now >= nextStats){
+                nextStats += std::chrono::seconds(5);
+                printStats();
+            }
+            outgoing.flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        printStats();
+    }
+
+    private:
+    std::array<std::uint8_t, sf::UdpSocket::MaxDatagramSize> receiveBuffer;
+    std::uint64_t nonceKey;
+
+    // Stateless per-address cookie: an unconfirmed Join costs no memory, and only the real owner of the address sees it.
+    std::uint32_t nonceFor(const sf::IpAddress& address, unsigned short port) const {
+        std::uint64_t x = nonceKey ^ (std::uint64_t(address.toInteger()) << 16 | port);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<std::uint32_t>(x ^ (x >> 31));
+    }
+
+    Player* findPlayer(const sf::IpAddress& address, unsigned short port){
+        for (Player& player : players){
+            if (player.address == address && player.port == port) return &player;
+        }
+        return nullptr;
+    }
+
+    int freeSnakeIndex() const {
+        for (int i = 0; i < sim.snakeCount; i++){
+            bool isTaken = false;
+            for (const Player& player : players) isTaken = isTaken || player.snakeIndex == i;
+            if (!isTaken) return i;
+        }
+        return NetProtocol::spectator;
+    }
+
+    bool isFull() const {
+        return freeSnakeIndex() == NetProtocol::spectator && static_cast<int>(players.size()) >= sim.snakeCount + maxSpectators;
+    }
+
+    void sendWelcome(const sf::IpAddress& address, unsigned short port, int snakeIndex){
+        ByteWriter out;
+        out.u8(NetProtocol::Welcome);
+        out.u8(static_cast<std::uint8_t>(snakeIndex));
+        out.varint(moveIntervalMs);
+        out.varint(tick);
+        out.varint(nonceFor(address, port));
+        outgoing.send(out.bytes, address, port);
+    }
+
+    void receive(){
+        std::size_t received;
+        sf::IpAddress sender;
+        unsigned short senderPort;
+        while (socket.receive(receiveBuffer.data(), receiveBuffer.size(), received, sender, senderPort) == sf::Socket::Done){
+            if (received == 0) continue;
+            ByteReader in(receiveBuffer.data(), received);
+            std::uint8_t type = in.u8();
+            Player* player = findPlayer(sender, senderPort);
+            if (type == NetProtocol::Join){
+                if (received < NetProtocol::joinSize || (!player && isFull())) continue;
+                sendWelcome(sender, senderPort, player ? player->snakeIndex : freeSnakeIndex());
+                continue;
+            }
+            if (type == NetProtocol::Confirm){
+                std::uint32_t nonce = in.varint();
+                if (!in.isValid || nonce != nonceFor(sender, senderPort)) continue;
+                if (!player){
+                    if (isFull()) continue;
+                    players.push_back(Player{sender, senderPort, freeSnakeIndex(), 0, 0, NetProtocol::noInput});
+                    player = &players.back();
+                    std::cout << "Client " << sender.toString() << ":" << senderPort << " joined as "
+                              << (player->snakeIndex == NetProtocol::spectator ? std::string("spectator") : "snake " + std::to_string(player->snakeIndex + 1)) << "\n";
+                }
+                player->lastHeard = std::chrono::steady_clock::now();
+                sendWelcome(sender, senderPort, player->snakeIndex);
+                continue;
+            }
+            if (!player) continue;
+            player->lastHeard = std::chrono::steady_clock::now();
+            if (type == NetProtocol::Input) handleInput(*player, in);
+            else if (type == NetProtocol::Restart && (sim.youLose || sim.youWon)) sim.restart();
+            else if (type == NetProtocol::Leave) removePlayer(sender, senderPort);
+        }
+        auto now = std::chrono::steady_clock::now();
+        std::erase_if(players, [&](const Player& player){
+            if (now - player.lastHeard <= std::chrono::seconds(5)) return false;
+            std::cout << "Client " << player.address.toString() << ":" << player.port << " timed out\n";
+            return true;
+        });
+    }
+
+    void removePlayer(const sf::IpAddress& address, unsigned short port){
+        for (std::size_t i = 0; i < players.size(); i++){
+            if (players[i].address != address || players[i].port != port) continue;
+            std::cout << "Client " << address.toString() << ":" << port << " left\n";
+            players.erase(players.begin() + i);
+            return;
+        }
+    }
+
+    void handleInput(Player& player, ByteReader& in){
+        std::uint32_t ackTick = in.varint(), echoMs = in.varint();
+        std::uint8_t count = in.u8();
+        if (!in.isValid || ackTick > tick) return;
+        player.ackTick = ackTick == 0 ? 0 : std::max(player.ackTick, ackTick);
+        player.echoMs = echoMs;
+        for (std::uint8_t i = 0; i < count; i++){
+            std::uint32_t inputTick = in.varint();
+            std::uint8_t code = in.u8();
+            if (!in.isValid || code > 3) return;
+            if (inputTick <= tick){
+                if (inputTick + NetProtocol::inputRedundancy > tick && player.inputTicks[inputTick % NetProtocol::historySize] != inputTick){
+                    player.inputTicks[inputTick % NetProtocol::historySize] = inputTick;
+                    player.lateCode = code;
+                }
+            } else if (inputTick - tick < NetProtocol::historySize){
+                std::size_t slot = inputTick % NetProtocol::historySize;
+                player.inputTicks[slot] = inputTick, player.inputCodes[slot] = code;
+            }
+        }
+    }
+
+    void step(){
+        tick++;
+        for (Player& player : players){
+            std::size_t slot = tick % NetProtocol::historySize;
+            std::uint8_t code = player.inputTicks[slot] == tick ? player.inputCodes[slot] : player.lateCode;
+            if (code != NetProtocol::noInput) sim.turn(player.snakeIndex, SnakeSim::toDirection(code));
+            player.lateCode = NetProtocol::noInput;
+        }
+        sim.step();
+        NetBaseline& current = history[tick % NetProtocol::historySize];
+        current = NetBaseline::capture(sim, tick);
+        ByteWriter out;
+        for (Player& player : players){
+            const NetBaseline* base = nullptr;
+            if (player.ackTick != 0 && tick - player.ackTick < NetProtocol::historySize && history[player.ackTick % NetProtocol::historySize].tick == player.ackTick){
+                base = &history[player.ackTick % NetProtocol::historySize];
+            }
+            out.clear();
+            out.u8(NetProtocol::State);
+            out.varint(tick);
+            out.varint(base ? base->tick : 0);
+            out.varint(player.echoMs);
+            NetStateCodec::encode(out, sim, current, base);
+            outgoing.send(out.bytes, player.address, player.port);
+            stateBytes += out.bytes.size(), statePackets++;
+            statsBytes += out.bytes.size(), statsPackets++;
+            if (!base) fullStates++;
+        }
+    }
+
+    void printStats(){
+        if (statsPackets == 0) return;
+        std::cout << "tick " << tick << ": " << players.size() << " client(s), " << statsBytes / statsPackets << " bytes/tick/client ("
+                  << statsBytes * 1000 / moveIntervalMs / std::max<std::uint64_t>(statsPackets, 1) << " B/s/client), "
+                  << fullStates << " full states, " << outgoing.droppedPackets << " dropped\n";
+        statsBytes = 0, statsPackets = 0;
+    }
+};
+
+void printUsage(){
+    std::cout << "Usage: game_server [--port N] [--mode CLS|INF|ARC] [--snakes N] [--holes N] [--width N] [--height N] [--interval MS]\n"
+                 "                   [--spectators N] [--delay MS] [--jitter MS] [--loss PERCENT] [--seed N]\n";
+}
+
+int main(int argc, char* argv[]){
+    GameServer server;
+    unsigned short port = NetProtocol::defaultPort;
+    std::string mode = "CLS";
+    server.sim.isCLSModeStarted = true;
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if (i + 1 >= argc){
+            printUsage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--port"){
+            if (NetProtocol::parsePort(value, port)) continue;
+            std::cerr << "Invalid value for --port: " << value << " (expected 1..65535)\n";
+            return 1;
+        }
+        try {
+            if (arg == "--mode") mode = value;
+            else if (arg == "--snakes") server.sim.snakeCount = std::clamp(std::stoi(value), 1, BoardGrid::maxSnakes);
+            else if (arg == "--holes") server.sim.holeCount = std::clamp(std::stoi(value), 0, SnakeSim::maxHoles);
+            else if (arg == "--width") server.sim.boardWidth = std::stoi(value);
+            else if (arg == "--height") server.sim.boardHeight = std::stoi(value);
+            else if (arg == "--interval") server.moveIntervalMs = std::max(std::stoi(value), 10);
+            else if (arg == "--spectators") server.maxSpectators = std::clamp(std::stoi(value), 0, 64);
+            else if (arg == "--delay") server.outgoing.delayMs = std::stoi(value);
+            else if (arg == "--jitter") server.outgoing.jitterMs = std::stoi(value);
+            else if (arg == "--loss") server.outgoing.lossRate = std::stof(value) / 100.f;
+            else if (arg == "--seed") server.sim.reseed(static_cast<std::uint32_t>(std::stoul(value)));
+            else {
+                printUsage();
+                return 1;
+            }
+        } catch (const std::exception&){
+            std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+            return 1;
+        }
+    }
+    server.sim.isCLSModeStarted = mode == "CLS", server.sim.isINFModeStarted = mode == "INF", server.sim.isARCModeStarted = mode == "ARC";
+    if (!server.sim.isCLSModeStarted && !server.sim.isINFModeStarted && !server.sim.isARCModeStarted){
+        printUsage();
+        return 1;
+    }
+    std::signal(SIGINT, [](int){ isRunning = false; });
+    if (!server.start(port)) return 1;
+    server.run();
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+#include <span>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+struct HoleShape {
+    int width, height;
+
+    bool operator==(const HoleShape&) const = default;
+};
+
+class HolePlacer {
+    public:
+    int width, height;
+    std::vector<HoleShape> shapes;
+    std::vector<sf::Vector2i> forbidden;
+
+    HolePlacer() : width{0}, height{0}, pairWeight{0}, conflictBound{0} {}
+
+    HolePlacer(int boardWidth, int boardHeight, std::vector<HoleShape> holeShapes, std::vector<sf::Vector2i> forbiddenCells) :
+        width{boardWidth}, height{boardHeight}, shapes{std::move(holeShapes)}, forbidden{std::move(forbiddenCells)}, pairWeight{0}, conflictBound{0} {
+        std::vector<std::uint32_t> forbiddenSum = prefixSum([&](std::vector<std::uint8_t>& mask){
+            for (sf::Vector2i cell : forbidden){
+                if (cell.x >= 0 && cell.y >= 0 && cell.x < width && cell.y < height) mask[cell.y * width + cell.x] = 1;
+            }
+        });
+        for (const HoleShape& shape : shapes){
+            auto found = std::find_if(tables.begin(), tables.end(), [&](const ShapeTable& table){ return table.shape == shape; });
+            tableOf.push_back(static_cast<std::size_t>(found - tables.begin()));
+            if (found == tables.end()) tables.push_back(buildTable(shape, forbiddenSum));
+        }
+        if (shapes.size() >= 2) buildPairWeights();
+        for (const HoleShape& shape : shapes) conflictBound = std::max<std::size_t>(conflictBound, static_cast<std::size_t>(2 * shape.width) * (2 * shape.height));
+        conflictBound *= shapes.size();
+    }
+
+    bool matches(int boardWidth, int boardHeight, std::span<const HoleShape> holeShapes, std::span<const sf::Vector2i> forbiddenCells) const {
+        return width == boardWidth && height == boardHeight && std::equal(shapes.begin(), shapes.end(), holeShapes.begin(), holeShapes.end()) &&
+               std::equal(forbidden.begin(), forbidden.end(), forbiddenCells.begin(), forbiddenCells.end());
+    }
+
+    std::size_t placementCount(std::size_t hole) const { return tables[tableOf[hole]].anchors.size(); }
+    std::uint64_t pairCount() const { return pairWeight; }
+
+    template <typename Rng>
+    int sample(Rng& rng, std::span<sf::Vector2i> out) const {
+        int holeCount = static_cast<int>(std::min(out.size(), shapes.size()));
+        if (holeCount == 0 || placementCount(0) == 0) return 0;
+        std::size_t first;
+        if (holeCount >= 2 && pairWeight > 0){
+            std::uint64_t pick = std::uniform_int_distribution<std::uint64_t>(0, pairWeight - 1)(rng);
+            first = static_cast<std::size_t>(std::upper_bound(firstWeights.begin(), firstWeights.end(), pick) - firstWeights.begin());
+        } else first = std::uniform_int_distribution<std::size_t>(0, placementCount(0) - 1)(rng);
+        out[0] = toPos(tables[tableOf[0]].anchors[first]);
+        thread_local std::vector<std::uint32_t> blocked;
+        if (blocked.capacity() < conflictBound) blocked.reserve(conflictBound);
+        for (int hole = 1; hole < holeCount; hole++){
+            const ShapeTable& table = tables[tableOf[hole]];
+            if (table.anchors.empty()) return hole;
+            std::uniform_int_distribution<std::size_t> anyAnchor(0, table.anchors.size() - 1);
+            bool isPlaced = false;
+            for (int attempt = 0; attempt < quickAttempts && !isPlaced; attempt++){
+                out[hole] = toPos(table.anchors[anyAnchor(rng)]);
+                isPlaced = true;
+                for (int other = 0; other < hole && isPlaced; other++) isPlaced = !overlaps(out[other], shapes[other], out[hole], shapes[hole]);
+            }
+            if (isPlaced) continue;
+            blocked.clear();
+            for (int other = 0; other < hole; other++){
+                Rect conflict = conflictRect(out[other], shapes[other], shapes[hole]);
+                for (int y = conflict.top; y < conflict.bottom; y++){
+                    for (int x = conflict.left; x < conflict.right; x++){
+                        if (table.anchorIndex[y * width + x] >= 0) blocked.push_back(static_cast<std::uint32_t>(table.anchorIndex[y * width + x]));
+                    }
+                }
+            }
+            std::sort(blocked.begin(), blocked.end());
+            blocked.erase(std::unique(blocked.begin(), blocked.end()), blocked.end());
+            if (blocked.size() == table.anchors.size()) return hole;
+            std::size_t pick = std::uniform_int_distribution<std::size_t>(0, table.anchors.size() - blocked.size() - 1)(rng);
+            for (std::uint32_t index : blocked){
+                if (index > pick) break;
+                pick++;
+            }
+            out[hole] = toPos(table.anchors[pick]);
+        }
+        return holeCount;
+    }
+
+    private:
+    static constexpr int quickAttempts = 8;
+
+    struct ShapeTable {
+        HoleShape shape;
+        std::vector<std::uint32_t> anchors, anchorSum;
+        std::vector<std::int32_t> anchorIndex;
+    };
+
+    struct Rect {
+        int left, top, right, bottom;
+    };
+
+    std::vector<ShapeTable> tables;
+    std::vector<std::size_t> tableOf;
+    std::vector<std::uint64_t> firstWeights;
+    std::uint64_t pairWeight;
+    std::size_t conflictBound;
+
+    sf::Vector2i toPos(std::uint32_t cell) const { return sf::Vector2i(cell % width, cell / width); }
+
+    static bool overlaps(sf::Vector2i a, HoleShape aShape, sf::Vector2i b, HoleShape bShape){
+        return a.x < b.x + bShape.width && b.x < a.x + aShape.width && a.y < b.y + bShape.height && b.y < a.y + aShape.height;
+    }
+
+    template <typename Fill>
+    std::vector<std::uint32_t> prefixSum(Fill&& fill) const {
+        std::vector<std::uint8_t> mask(static_cast<std::size_t>(width) * height, 0);
+        fill(mask);
+        std::vector<std::uint32_t> sum(static_cast<std::size_t>(width + 1) * (height + 1), 0);
+        for (int y = 0; y < height; y++){
+            for (int x = 0; x < width; x++) sum[(y + 1) * (width + 1) + x + 1] = mask[y * width + x] + sum[y * (width + 1) + x + 1] + sum[(y + 1) * (width + 1) + x] - sum[y * (width + 1) + x];
+        }
+        return sum;
+    }
+
+    std::uint32_t rectSum(const std::vector<std::uint32_t>& sum, Rect rect) const {
+        if (rect.left >= rect.right || rect.top >= rect.bottom) return 0;
+        return sum[rect.bottom * (width + 1) + rect.right] - sum[rect.top * (width + 1) + rect.right] - sum[rect.bottom * (width + 1) + rect.left] + sum[rect.top * (width + 1) + rect.left];
+    }
+
+    Rect conflictRect(sf::Vector2i placed, HoleShape placedShape, HoleShape shape) const {
+        return Rect{std::max(placed.x - shape.width + 1, 0), std::max(placed.y - shape.height + 1, 0),
+                    std::min(placed.x + placedShape.width, width - shape.width + 1), std::min(placed.y + placedShape.height, height - shape.height + 1)};
+    }
+
+    ShapeTable buildTable(HoleShape shape, const std::vector<std::uint32_t>& forbiddenSum) const {
+        ShapeTable table{shape, {}, {}, std::vector<std::int32_t>(static_cast<std::size_t>(width) * height, -1)};
+        for (int y = 0; y + shape.height <= height; y++){
+            for (int x = 0; x + shape.width <= width; x++){
+                if (rectSum(forbiddenSum, Rect{x, y, x + shape.width, y + shape.height}) != 0) continue;
+                table.anchorIndex[y * width + x] = static_cast<std::int32_t>(table.anchors.size());
+                table.anchors.push_back(static_cast<std::uint32_t>(y * width + x));
+            }
+        }
+        table.anchorSum = prefixSum([&](std::vector<std::uint8_t>& mask){
+            for (std::uint32_t cell : table.anchors) mask[cell] = 1;
+        });
+        return table;
+    }
+
+    void buildPairWeights(){
+        const ShapeTable& firstTable = tables[tableOf[0]];
+        const ShapeTable& secondTable = tables[tableOf[1]];
+        firstWeights.resize(firstTable.anchors.size());
+        for (std::size_t i = 0; i < firstTable.anchors.size(); i++){
+            std::uint32_t conflicts = rectSum(secondTable.anchorSum, conflictRect(toPos(firstTable.anchors[i]), shapes[0], shapes[1]));
+            pairWeight += secondTable.anchors.size() - conflicts;
+            firstWeights[i] = pairWeight;
+        }
+    }
+};
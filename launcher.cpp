@@ -1,22 +1,17 @@
 #include <iostream>
-#include <windows.h>
+#include "platform.h"
 
 int main() {
-    if (!SetDllDirectoryA("libs")) {
+    if (!Platform::setLibraryDirectory("libs")) {
         std::cerr << "Failed to set DLL path." << std::endl;
         return 1;
     }
 
-    STARTUPINFO si = { sizeof(si) };
-    PROCESS_INFORMATION pi;
-    if (CreateProcess("core.exe", NULL, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi)) {
-        CloseHandle(pi.hProcess);
-        CloseHandle(pi.hThread);
-    } else {
-        std::cerr << "Failed to start game: " << GetLastError() << std::endl;
+    if (!Platform::launch(Platform::executableName("core"))) {
+        std::cerr << "Failed to start game: " << Platform::lastError() << std::endl;
         return 1;
     }
 
     std::cout << "Game started!" << std::endl;
     return 0;
-}
\ No newline at end of file
+}
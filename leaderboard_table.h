@@ -0,0 +1,170 @@
+#pragma once
+#include "log.h"
+#include <nlohmann/json.hpp>
+#include <vector>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+class LeaderboardTable {
+    public:
+    struct Entry {
+        std::string_view name;
+        int score;
+    };
+    static constexpr std::size_t blockSize = 64 * 1024;
+    static constexpr std::size_t minEntryBytes = 32;
+
+    LeaderboardTable() : blockUsed{blockSize}, internedCount{0} {}
+    LeaderboardTable(LeaderboardTable&&) = default;
+    LeaderboardTable& operator=(LeaderboardTable&&) = default;
+    LeaderboardTable(const LeaderboardTable&) = delete;
+    LeaderboardTable& operator=(const LeaderboardTable&) = delete;
+
+    void clear(){
+        entries.clear();
+        names.clear();
+        blocks.clear();
+        blockUsed = blockSize, internedCount = 0;
+    }
+
+    void reserve(std::size_t entryCount){
+        entries.reserve(entryCount);
+        names.reserve(entryCount);
+    }
+
+    std::string_view intern(std::string_view name){
+        auto it = names.find(name);
+        if (it != names.end()) return *it;
+        if (blockUsed + name.size() > blockSize){
+            blocks.push_back(std::make_unique<char[]>(std::max(blockSize, name.size())));
+            blockUsed = 0;
+        }
+        char* stored = blocks.back().get() + blockUsed;
+        std::memcpy(stored, name.data(), name.size());
+        blockUsed += name.size();
+        return *names.insert(std::string_view(stored, name.size())).first;
+    }
+
+    void add(std::string_view name, int score){
+        entries.push_back(Entry{intern(name), score});
+    }
+
+    void sortByScore(){
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b){ return a.score > b.score; });
+    }
+
+    bool parse(const std::string& body){
+        clear();
+        reserve(body.size() / minEntryBytes);
+        SaxHandler handler{*this};
+        if (!nlohmann::json::sax_parse(body, &handler)){
+            LOG_ERROR("Failed to parse leaderboard", "reason", handler.error.empty() ? std::string_view("unexpected entry layout") : std::string_view(handler.error));
+            clear();
+            return false;
+        }
+        sortByScore();
+        entries.shrink_to_fit();
+        internedCount = names.size();
+        std::unordered_set<std::string_view>().swap(names);
+        return true;
+    }
+
+    std::size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    const Entry& operator[](std::size_t i) const { return entries[i]; }
+    std::vector<Entry>::const_iterator begin() const { return entries.begin(); }
+    std::vector<Entry>::const_iterator end() const { return entries.end(); }
+    std::size_t uniqueNames() const { return names.empty() ? internedCount : names.size(); }
+
+    // Writes each entry as "rank. name - score" into one reused string and passes it to visit(index, row).
+    // The leaderboard screen and alloc_bench both build their rows here.
+    template <typename Visit>
+    void formatRows(std::string& row, Visit&& visit) const {
+        char number[16];
+        for (std::size_t i = 0; i < entries.size(); i++){
+            row.clear();
+            row.append(number, std::to_chars(number, number + sizeof(number), i + 1).ptr);
+            row += ". ";
+            row += entries[i].name;
+            row += " - ";
+            row.append(number, std::to_chars(number, number + sizeof(number), entries[i].score).ptr);
+            visit(i, static_cast<const std::string&>(row));
+        }
+    }
+
+    private:
+    std::vector<Entry> entries;
+    std::unordered_set<std::string_view> names;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::size_t blockUsed, internedCount;
+
+    struct SaxHandler {
+        enum Field { Other, Username, Highscore };
+        LeaderboardTable& table;
+        int depth = 0;
+        Field field = Other;
+        bool hasName = false, hasScore = false;
+        std::string name;
+        long long score = 0;
+        std::string error;
+
+        SaxHandler(LeaderboardTable& table) : table{table} {}
+
+        bool scalar() const {
+            return depth > 2 || (depth == 2 && field == Other);
+        }
+        bool null(){ return scalar(); }
+        bool boolean(bool){ return scalar(); }
+        bool number_float(double, const std::string&){ return scalar(); }
+        bool binary(nlohmann::json::binary_t&){ return scalar(); }
+        bool number_integer(long long number){
+            if (depth != 2 || field != Highscore) return scalar();
+            score = number, hasScore = true;
+            return true;
+        }
+        bool number_unsigned(unsigned long long number){
+            return number_integer(static_cast<long long>(std::min<unsigned long long>(number, std::numeric_limits<int>::max())));
+        }
+        bool string(std::string& text){
+            if (depth != 2 || field != Username) return scalar();
+            name.assign(text), hasName = true;
+            return true;
+        }
+        bool key(std::string& text){
+            if (depth == 2) field = text == "username" ? Username : text == "highscore" ? Highscore : Other;
+            return true;
+        }
+        bool start_object(std::size_t){
+            if (depth == 0 || (depth == 2 && field != Other)) return false;
+            if (++depth == 2) hasName = false, hasScore = false, field = Other;
+            return true;
+        }
+        bool end_object(){
+            if (depth-- != 2) return true;
+            if (!hasName || !hasScore) return false;
+            int clamped = static_cast<int>(std::clamp<long long>(score, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+            if (clamped != 0) table.add(name, clamped);
+            field = Other;
+            return true;
+        }
+        bool start_array(std::size_t){
+            if (depth == 1 || (depth == 2 && field != Other)) return false;
+            depth++;
+            return true;
+        }
+        bool end_array(){
+            depth--;
+            return true;
+        }
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& e){
+            error = e.what();
+            return false;
+        }
+    };
+};
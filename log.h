@@ -0,0 +1,232 @@
+#pragma once
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <charconv>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <type_traits>
+
+enum class LogLevel : std::uint8_t { Debug, Info, Warn, Error };
+
+#ifndef SNAKE_LOG_MIN_LEVEL
+#if defined(NDEBUG)
+#define SNAKE_LOG_MIN_LEVEL 1
+#else
+#define SNAKE_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+// Sites below SNAKE_LOG_MIN_LEVEL compile to nothing; their arguments are never evaluated.
+#define SNAKE_LOG(level, ...) do { if constexpr (Logger::isEnabled(level)) Logger::instance().write(level, __VA_ARGS__); } while (false)
+#define LOG_DEBUG(...) SNAKE_LOG(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...) SNAKE_LOG(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...) SNAKE_LOG(LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) SNAKE_LOG(LogLevel::Error, __VA_ARGS__)
+
+struct LogSecret {
+    std::string_view value;
+};
+
+class LogLine {
+    public:
+    static constexpr std::size_t capacity = 232;
+    std::array<char, capacity> text;
+    std::size_t size = 0;
+
+    void append(std::string_view value){
+        std::size_t count = std::min(value.size(), capacity - size);
+        std::memcpy(text.data() + size, value.data(), count);
+        size += count;
+    }
+
+    void appendQuoted(std::string_view value){
+        bool isQuoted = value.empty() || value.find_first_of(" =\"\n\r\t") != std::string_view::npos;
+        if (isQuoted) append("\"");
+        for (std::size_t i = 0; i < value.size(); i++){
+            if (value.compare(i, 3, "eyJ") == 0){
+                append("<redacted>");
+                while (i + 1 < value.size() && isTokenChar(value[i + 1])) i++;
+            } else if (value[i] == '"' || value[i] == '\\'){
+                append("\\");
+                append(value.substr(i, 1));
+            } else if (value[i] == '\n') append("\\n");
+            else if (value[i] != '\r') append(value.substr(i, 1));
+        }
+        if (isQuoted) append("\"");
+    }
+
+    template <typename T>
+    void appendValue(const T& value){
+        using Type = std::decay_t<T>;
+        if constexpr (std::is_same_v<Type, LogSecret>) append("<redacted>");
+        else if constexpr (std::is_same_v<Type, bool>) append(value ? "true" : "false");
+        else if constexpr (std::is_arithmetic_v<Type>){
+            char number[32];
+            auto end = std::to_chars(number, number + sizeof(number), value).ptr;
+            append(std::string_view(number, end - number));
+        } else appendQuoted(std::string_view(value));
+    }
+
+    template <typename Value, typename... Rest>
+    void appendFields(std::string_view key, const Value& value, const Rest&... rest){
+        append(" ");
+        append(key);
+        append("=");
+        if (isSecretKey(key)) append("<redacted>");
+        else appendValue(value);
+        if constexpr (sizeof...(rest) > 0) appendFields(rest...);
+    }
+
+    private:
+    static bool isTokenChar(char c){
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.';
+    }
+
+    static bool isSecretKey(std::string_view key){
+        for (std::string_view secret : {"token", "password", "secret", "authorization", "apikey"}){
+            if (key.size() >= secret.size() && key.compare(key.size() - secret.size(), secret.size(), secret) == 0) return true;
+        }
+        return false;
+    }
+};
+
+class Logger {
+    public:
+    static constexpr LogLevel minLevel = static_cast<LogLevel>(SNAKE_LOG_MIN_LEVEL);
+    static constexpr std::size_t slotCount = 1024;
+
+    static constexpr bool isEnabled(LogLevel level){ return level >= minLevel; }
+
+    static Logger& instance(){
+        static Logger logger;
+        return logger;
+    }
+
+    ~Logger(){
+        stop();
+    }
+
+    // Every record goes to path; when the file passes maxBytes it becomes path.1, path.1 becomes path.2 and so on.
+    void start(const std::string& path, std::uintmax_t maxBytes = 1 << 20, int keepFiles = 3){
+        if (isRunning.exchange(true)) return;
+        logPath = path, rotateBytes = maxBytes, rotateKeep = keepFiles;
+        writer = std::thread([this]{ runWriter(); });
+    }
+
+    void stop(){
+        if (!isRunning.exchange(false)) return;
+        if (writer.joinable()) writer.join();
+    }
+
+    // Message first, then key/value pairs. Never blocks: a full ring drops the record and counts it.
+    template <typename... Fields>
+    void write(LogLevel level, std::string_view message, const Fields&... fields){
+        static_assert(sizeof...(Fields) % 2 == 0, "Log fields come in key/value pairs");
+        std::size_t position = head.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true){
+            slot = &slots[position % slotCount];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == position){
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (sequence < position){
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else position = head.load(std::memory_order_relaxed);
+        }
+        slot->level = level;
+        slot->time = std::chrono::system_clock::now();
+        slot->line.size = 0;
+        slot->line.append(message);
+        if constexpr (sizeof...(Fields) > 0) slot->line.appendFields(fields...);
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    std::size_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        LogLevel level;
+        std::chrono::system_clock::time_point time;
+        LogLine line;
+    };
+
+    std::array<Slot, slotCount> slots;
+    alignas(64) std::atomic<std::size_t> head;
+    alignas(64) std::size_t tail;
+    std::atomic<std::size_t> dropped;
+    std::atomic<bool> isRunning;
+    std::thread writer;
+    std::string logPath;
+    std::uintmax_t rotateBytes;
+    int rotateKeep;
+
+    Logger() : head{0}, tail{0}, dropped{0}, isRunning{false}, rotateBytes{0}, rotateKeep{0} {
+        for (std::size_t i = 0; i < slotCount; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    static std::string_view levelName(LogLevel level){
+        static constexpr std::array<std::string_view, 4> names = {"DEBUG", "INFO ", "WARN ", "ERROR"};
+        return names[static_cast<std::size_t>(level)];
+    }
+
+    bool drain(std::ofstream& file, std::uintmax_t& fileBytes, std::string& out){
+        std::size_t reported = 0;
+        out.clear();
+        while (true){
+            Slot& slot = slots[tail % slotCount];
+            if (slot.sequence.load(std::memory_order_acquire) != tail + 1) break;
+            auto time = std::chrono::floor<std::chrono::milliseconds>(slot.time);
+            auto day = std::chrono::floor<std::chrono::days>(time);
+            std::chrono::year_month_day date(day);
+            std::chrono::hh_mm_ss clock(time - day);
+            char stamp[32];
+            int length = std::snprintf(stamp, sizeof(stamp), "%04d-%02u-%02uT%02d:%02d:%02d.%03dZ ", static_cast<int>(date.year()), static_cast<unsigned>(date.month()), static_cast<unsigned>(date.day()),
+                                       static_cast<int>(clock.hours().count()), static_cast<int>(clock.minutes().count()), static_cast<int>(clock.seconds().count()), static_cast<int>(clock.subseconds().count()));
+            std::size_t lineStart = out.size();
+            out.append(stamp, length).append(levelName(slot.level)).append(" ").append(slot.line.text.data(), slot.line.size).append("\n");
+            (slot.level >= LogLevel::Warn ? std::cerr : std::cout) << std::string_view(out).substr(lineStart + length);
+            slot.sequence.store(tail + slotCount, std::memory_order_release);
+            tail++, reported++;
+        }
+        std::size_t lost = dropped.exchange(0, std::memory_order_relaxed);
+        if (lost) out += "log ring full, dropped " + std::to_string(lost) + " records\n";
+        if (out.empty()) return false;
+        if (fileBytes + out.size() > rotateBytes && fileBytes > 0) rotate(file, fileBytes);
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        file.flush();
+        fileBytes += out.size();
+        return reported > 0;
+    }
+
+    void rotate(std::ofstream& file, std::uintmax_t& fileBytes){
+        file.close();
+        std::error_code error;
+        for (int i = rotateKeep - 1; i >= 1; i--) std::filesystem::rename(logPath + "." + std::to_string(i), logPath + "." + std::to_string(i + 1), error);
+        if (rotateKeep > 0) std::filesystem::rename(logPath, logPath + ".1", error);
+        file.open(logPath, std::ios::binary | std::ios::trunc);
+        fileBytes = 0;
+    }
+
+    void runWriter(){
+        std::error_code error;
+        std::filesystem::path parent = std::filesystem::path(logPath).parent_path();
+        if (!parent.empty()) std::filesystem::create_directories(parent, error);
+        std::ofstream file(logPath, std::ios::binary | std::ios::app);
+        std::uintmax_t fileBytes = std::filesystem::exists(logPath, error) ? std::filesystem::file_size(logPath, error) : 0;
+        std::string out;
+        while (isRunning.load(std::memory_order_acquire)){
+            if (!drain(file, fileBytes, out)) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        drain(file, fileBytes, out);
+    }
+};
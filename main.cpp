@@ -1,4 +1,6 @@
 #define CPPHTTPLIB_OPENSSL_SUPPORT
+#define CPPHTTPLIB_ZLIB_SUPPORT
+#define CPPHTTPLIB_BROTLI_SUPPORT
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 #include <iostream>
@@ -7,74 +9,463 @@
 #include <array>
 #include <string>
 #include <random>
-#include <deque>
+#include <span>
 #include <algorithm>
 #include <cmath>
 #include <numbers>
+#include <charconv>
+#include <string_view>
+#include <chrono>
+#include <filesystem>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <pqxx/pqxx>
 #include "include/httplib.h"
+#include "net_protocol.h"
+#include "snake_replay.h"
+#include "leaderboard_table.h"
+#include "asset_pack.h"
 #include <nlohmann/json.hpp>
-#include <windows.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include "platform.h"
+#include "log.h"
+#include "alloc_tracker.h"
+
+class CredentialStore {
+    public:
+    std::string token, path, keyPath;
+    std::int64_t expiry;
+    bool isEncrypted;
+
+    CredentialStore() : path{"credentials.dat"}, keyPath{"credentials.key"}, expiry{0}, isEncrypted{true} {}
+
+    bool isExpired() const {
+        return expiry != 0 && std::chrono::system_clock::now() >= std::chrono::system_clock::time_point(std::chrono::seconds(expiry));
+    }
+
+    void load(){
+        token.clear();
+        expiry = 0;
+        std::string buffer;
+        if (!readFile(path, buffer) || buffer.size() < 5 || buffer.compare(0, 4, "SGC1") != 0) return;
+        if (buffer[4] == 0) token = buffer.substr(5);
+        else if (buffer[4] == 1){
+            std::string key;
+            if (!readFile(keyPath, key) || key.size() != 32 || !decrypt(key, std::string_view(buffer).substr(5), token)) {
+                LOG_WARN("Failed to decrypt stored credentials", "path", path);
+                token.clear();
+                return;
+            }
+        }
+        expiry = tokenExpiry(token);
+    }
+
+    bool save(const std::string& newToken){
+        if (newToken == token && std::filesystem::exists(path)) return true;
+        std::string buffer = "SGC1";
+        if (isEncrypted){
+            std::string key, sealed;
+            if (!readFile(keyPath, key) || key.size() != 32){
+                key.assign(32, '\0');
+                if (RAND_bytes(reinterpret_cast<unsigned char*>(key.data()), 32) != 1 || !writeFile(keyPath, key)) return false;
+            }
+            if (!encrypt(key, newToken, sealed)) return false;
+            buffer += '\1';
+            buffer += sealed;
+        } else {
+            buffer += '\0';
+            buffer += newToken;
+        }
+        if (!writeFile(path, buffer)) return false;
+        token = newToken;
+        expiry = tokenExpiry(token);
+        return true;
+    }
+
+    void clear(){
+        token.clear();
+        expiry = 0;
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+
+    static std::int64_t tokenExpiry(const std::string& jwt){
+        std::size_t first = jwt.find('.'), second = jwt.find('.', first + 1);
+        if (first == std::string::npos || second == std::string::npos) return 0;
+        std::string payload;
+        unsigned int bits = 0;
+        int bitCount = 0;
+        for (char c : std::string_view(jwt).substr(first + 1, second - first - 1)){
+            int value;
+            if (c >= 'A' && c <= 'Z') value = c - 'A';
+            else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+            else if (c >= '0' && c <= '9') value = c - '0' + 52;
+            else if (c == '-' || c == '+') value = 62;
+            else if (c == '_' || c == '/') value = 63;
+            else break;
+            bits = (bits << 6) | value;
+            bitCount += 6;
+            if (bitCount >= 8){
+                bitCount -= 8;
+                payload += static_cast<char>((bits >> bitCount) & 0xFF);
+            }
+        }
+        nlohmann::json claims = nlohmann::json::parse(payload, nullptr, false);
+        if (claims.is_discarded() || !claims.contains("exp") || !claims["exp"].is_number()) return 0;
+        return claims["exp"].get<std::int64_t>();
+    }
+
+    private:
+    static bool readFile(const std::string& filePath, std::string& out){
+        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        out.assign(static_cast<std::size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        return static_cast<bool>(file.read(out.data(), out.size()));
+    }
+
+    static bool writeFile(const std::string& filePath, const std::string& data){
+        std::string tempPath = filePath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+        }
+        std::error_code ec;
+        std::filesystem::permissions(tempPath, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write, std::filesystem::perm_options::replace, ec);
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.write(data.data(), data.size())) return false;
+        }
+        std::filesystem::rename(tempPath, filePath, ec);
+        return !ec;
+    }
+
+    static bool encrypt(const std::string& key, const std::string& plain, std::string& out){
+        unsigned char iv[12], tag[16];
+        if (RAND_bytes(iv, sizeof(iv)) != 1) return false;
+        std::string cipher(plain.size(), '\0');
+        int len = 0;
+        EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+        bool ok = ctx &&
+            EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, reinterpret_cast<const unsigned char*>(key.data()), iv) == 1 &&
+            EVP_EncryptUpdate(ctx, reinterpret_cast<unsigned char*>(cipher.data()), &len, reinterpret_cast<const unsigned char*>(plain.data()), static_cast<int>(plain.size())) == 1 &&
+            EVP_EncryptFinal_ex(ctx, reinterpret_cast<unsigned char*>(cipher.data()) + len, &len) == 1 &&
+            EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, sizeof(tag), tag) == 1;
+        EVP_CIPHER_CTX_free(ctx);
+        if (!ok) return false;
+        out.assign(reinterpret_cast<char*>(iv), sizeof(iv));
+        out.append(reinterpret_cast<char*>(tag), sizeof(tag));
+        out += cipher;
+        return true;
+    }
+
+    static bool decrypt(const std::string& key, std::string_view sealed, std::string& out){
+        if (sealed.size() < 28) return false;
+        std::string tag(sealed.substr(12, 16));
+        std::string_view cipher = sealed.substr(28);
+        out.assign(cipher.size(), '\0');
+        int len = 0;
+        EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+        bool ok = ctx &&
+            EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, reinterpret_cast<const unsigned char*>(key.data()), reinterpret_cast<const unsigned char*>(sealed.data())) == 1 &&
+            EVP_DecryptUpdate(ctx, reinterpret_cast<unsigned char*>(out.data()), &len, reinterpret_cast<const unsigned char*>(cipher.data()), static_cast<int>(cipher.size())) == 1 &&
+            EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, 16, tag.data()) == 1 &&
+            EVP_DecryptFinal_ex(ctx, reinterpret_cast<unsigned char*>(out.data()) + len, &len) == 1;
+        EVP_CIPHER_CTX_free(ctx);
+        return ok;
+    }
+};
+
+struct PendingScore {
+    int score;
+    std::vector<std::uint8_t> replay;
+};
 
 class ServerClient {
     private:
-    httplib::Client client;
+    static constexpr const char* serverUrl = "https://localhost:8080";
+    static constexpr const char* leaderboardCachePath = "leaderboard.cache";
+    httplib::Client client, healthClient;
+    std::thread healthThread;
+    std::mutex monitorMutex;
+    std::condition_variable monitorWake;
+    std::atomic<unsigned int> stateRevision;
+    unsigned int seenRevision;
+    bool isMonitorRunning, isProbeRequested, isRefreshRequested;
+    std::atomic<bool> isTokenRejected;
+    std::string refreshToken;
+    std::mutex leaderboardMutex;
+    std::string leaderboardETag;
+    std::shared_ptr<const LeaderboardTable> leaderboardTable;
+    std::vector<PendingScore> pendingScores;
     
     bool sendPostRequest(const std::string& endpoint, const nlohmann::json& body) {
         if (!isOnline) {
-            std::cout << "No connection to server.\n";
+            LOG_INFO("No connection to server", "endpoint", endpoint);
             return false;
         }
         if (!client.is_valid()) {
-            std::cerr << "Error: client invalid!" << std::endl;
+            LOG_ERROR("HTTP client is invalid", "url", serverUrl);
             return false;
         }
         httplib::Result result = client.Post(endpoint, body.dump(), "application/json");
+        if (!result) markOffline();
         return result && result->status == 200;
     }
 
+    void setOnline(bool online) {
+        if (isOnline.exchange(online) == online) return;
+        stateRevision++;
+        if (online) LOG_INFO("Connected to server", "url", serverUrl);
+        else LOG_WARN("Lost connection to server", "url", serverUrl);
+    }
+
+    void markOffline() {
+        setOnline(false);
+        {
+            std::lock_guard lock(monitorMutex);
+            isProbeRequested = true;
+        }
+        monitorWake.notify_all();
+    }
+
+    void runHealthMonitor() {
+        SNAKE_ALLOC_SCOPE(AllocTag::Network);
+        int backoffMs = minBackoffMs;
+        bool hasProbed = false, isProbeDue = true;
+        auto nextProbe = std::chrono::steady_clock::now();
+        std::unique_lock lock(monitorMutex);
+        while (isMonitorRunning) {
+            isProbeDue = isProbeDue || isProbeRequested || !isOnline;
+            std::string token = isRefreshRequested || isProbeDue ? refreshToken : std::string();
+            isProbeRequested = false, isRefreshRequested = false;
+            lock.unlock();
+            if (isProbeDue) {
+                httplib::Result result = healthClient.Get("/");
+                bool online = result && result->status == 200;
+                if (!online && !hasProbed) LOG_WARN("Connection to server failed, retrying in the background", "url", serverUrl);
+                hasProbed = true;
+                setOnline(online);
+                nextProbe = std::chrono::steady_clock::now() + std::chrono::milliseconds(online ? healthIntervalMs : backoffMs);
+                backoffMs = online ? minBackoffMs : std::min(backoffMs * 2, maxBackoffMs);
+            }
+            if (isOnline && submitPendingScores()) {
+                std::lock_guard scoreLock(monitorMutex);
+                token = refreshToken;
+            }
+            if (isOnline && !token.empty()) {
+                httplib::Result result = healthClient.Get("/leaderboard", leaderboardHeaders(token));
+                if (result) publishTokenState(token, *result);
+            }
+            lock.lock();
+            isProbeDue = !monitorWake.wait_until(lock, nextProbe, [this]{ return !isMonitorRunning || isProbeRequested || isRefreshRequested || (isOnline && !pendingScores.empty()); });
+        }
+    }
+
+    // Runs on the health monitor thread with its own client. Scores that got no response stay queued for the next probe.
+    bool submitPendingScores() {
+        std::vector<PendingScore> scores;
+        std::string token;
+        {
+            std::lock_guard lock(monitorMutex);
+            scores.swap(pendingScores);
+            token = refreshToken;
+        }
+        for (std::size_t i = 0; i < scores.size(); i++) {
+            if (token.empty()) {
+                LOG_WARN("Not authorized, score not sent", "score", scores[i].score);
+                continue;
+            }
+            nlohmann::json requestBody = {{"score", scores[i].score}, {"replay", ReplayLog::toBase64(scores[i].replay)}};
+            httplib::Result result = healthClient.Post("/update_user_score", {{"Authorization", "Bearer " + token}}, requestBody.dump(), "application/json");
+            if (!result) {
+                LOG_WARN("No response to score update, retrying when back online", "score", scores[i].score);
+                {
+                    std::lock_guard lock(monitorMutex);
+                    pendingScores.insert(pendingScores.begin(), std::make_move_iterator(scores.begin() + i), std::make_move_iterator(scores.end()));
+                }
+                markOffline();
+                return false;
+            }
+            if (result->status == 200) LOG_INFO("Score updated", "score", scores[i].score);
+            else LOG_ERROR("Failed to update score", "score", scores[i].score, "status", result->status);
+        }
+        return !scores.empty();
+    }
+
+    // The conditional /leaderboard request doubles as the token check. A token replaced or cleared meanwhile is left alone.
+    void publishTokenState(const std::string& token, const httplib::Response& response) {
+        bool isAccepted = applyLeaderboardResponse(response);
+        if (!isAccepted && response.status != 401 && response.status != 403) return;
+        std::lock_guard lock(monitorMutex);
+        if (token != refreshToken) return;
+        if (isAccepted) {
+            isAuthorized = true;
+            return;
+        }
+        LOG_WARN("Token validation failed", "status", response.status, "response", response.body);
+        refreshToken.clear();
+        isAuthorized = false;
+        isTokenRejected = true;
+        stateRevision++;
+    }
+
+    httplib::Headers leaderboardHeaders(const std::string& token) {
+        httplib::Headers headers = {{"Authorization", "Bearer " + token}};
+        std::lock_guard lock(leaderboardMutex);
+        if (!leaderboardETag.empty()) headers.emplace("If-None-Match", leaderboardETag);
+        return headers;
+    }
+
+    bool applyLeaderboardResponse(const httplib::Response& response) {
+        if (response.status == 304) return true;
+        if (response.status != 200) return false;
+        auto table = std::make_shared<LeaderboardTable>();
+        if (!table->parse(response.body)) return false;
+        std::string etag = response.get_header_value("ETag");
+        {
+            std::lock_guard lock(leaderboardMutex);
+            leaderboardTable = std::move(table);
+            leaderboardETag = etag;
+        }
+        leaderboardRevision++;
+        if (!etag.empty()) saveLeaderboardCache(etag, response.body);
+        return true;
+    }
+
+    void loadLeaderboardCache() {
+        std::ifstream file(leaderboardCachePath, std::ios::binary);
+        std::string etag, body;
+        if (!file.is_open() || !std::getline(file, etag)) return;
+        body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        auto table = std::make_shared<LeaderboardTable>();
+        if (etag.empty() || !table->parse(body)) return;
+        std::lock_guard lock(leaderboardMutex);
+        leaderboardTable = std::move(table);
+        leaderboardETag = etag;
+        leaderboardRevision++;
+    }
+
+    static void saveLeaderboardCache(const std::string& etag, const std::string& body) {
+        std::string tempPath = std::string(leaderboardCachePath) + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return;
+            file << etag << '\n' << body;
+            if (!file) return;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tempPath, leaderboardCachePath, ec);
+    }
+
+    void setRefreshToken(const std::string& token) {
+        std::lock_guard lock(monitorMutex);
+        refreshToken = token;
+    }
+
+    static void setTimeouts(httplib::Client& target, int connectMs, int readMs) {
+        target.set_connection_timeout(connectMs / 1000, (connectMs % 1000) * 1000);
+        target.set_read_timeout(readMs / 1000, (readMs % 1000) * 1000);
+    }
+
     public:
-    std::string token;
-    bool isAuthorized, isOnline;
+    static constexpr int minBackoffMs = 1000, maxBackoffMs = 30000;
+    static constexpr std::size_t maxPendingScores = 8;
+    CredentialStore credentials;
+    std::atomic<bool> isAuthorized;
+    std::atomic<bool> isOnline;
+    std::atomic<unsigned int> leaderboardRevision;
+    int connectTimeoutMs, readTimeoutMs, healthIntervalMs;
 
-    ServerClient() : client("https://localhost:8080") {
+    ServerClient() : client(serverUrl), healthClient(serverUrl), stateRevision{0}, seenRevision{0}, isMonitorRunning{false}, isProbeRequested{false}, isRefreshRequested{false}, isTokenRejected{false}, isAuthorized{false}, isOnline{false}, leaderboardRevision{0}, connectTimeoutMs{2000}, readTimeoutMs{5000}, healthIntervalMs{10000} {
+        credentials.load();
         client.set_default_headers({{"Content-Type", "application/json"}});
         client.set_ca_cert_path("server-cert.pem");
-        httplib::Result res = client.Get("/");
-        if (res && res->status == 200) {
-            isOnline = true;
-            std::cout << "Connected to server https://localhost:8080\n";
-        } else {
-            isOnline = false;
-            std::cout << "Connection to server failed! No response.\n";
+        healthClient.set_ca_cert_path("server-cert.pem");
+        loadLeaderboardCache();
+    }
+
+    ~ServerClient() {
+        stopHealthMonitor();
+    }
+
+    void startHealthMonitor() {
+        if (healthThread.joinable()) return;
+        setTimeouts(client, connectTimeoutMs, readTimeoutMs);
+        setTimeouts(healthClient, connectTimeoutMs, readTimeoutMs);
+        if (!credentials.token.empty() && !credentials.isExpired()) refreshToken = credentials.token;
+        isMonitorRunning = true;
+        healthThread = std::thread([this]{ runHealthMonitor(); });
+    }
+
+    void stopHealthMonitor() {
+        {
+            std::lock_guard lock(monitorMutex);
+            isMonitorRunning = false;
         }
+        monitorWake.notify_all();
+        if (healthThread.joinable()) healthThread.join();
     }
 
-    bool isTokenValid() {
-        if (!isOnline) {
-            std::cout << "No connection to server.\n";
-            return false;
+    void requestLeaderboardRefresh() {
+        {
+            std::lock_guard lock(monitorMutex);
+            isRefreshRequested = true;
         }
-        if (token.empty()) {
-            std::cerr << "Token is empty.\n";
+        monitorWake.notify_all();
+    }
+
+    std::shared_ptr<const LeaderboardTable> leaderboard() {
+        std::lock_guard lock(leaderboardMutex);
+        return leaderboardTable;
+    }
+
+    void logout() {
+        isAuthorized = false;
+        credentials.clear();
+        setRefreshToken("");
+    }
+
+    bool pollStateChange() {
+        unsigned int revision = stateRevision.load();
+        if (revision == seenRevision) return false;
+        seenRevision = revision;
+        return true;
+    }
+
+    // Local checks only. The health monitor confirms the token with the server and publishes isAuthorized.
+    bool requestTokenValidation() {
+        if (credentials.token.empty()) {
+            LOG_WARN("Token is empty");
             isAuthorized = false;
             return false;
         }
-        httplib::Headers headers = {{"Authorization", "Bearer " + token}};
-        httplib::Result result = client.Get("/leaderboard", headers);
-        if (!result || result->status != 200) {
-            std::cerr << "Token validation failed. Server response: " << (result ? result->body : "No response") << "\n";
-            isAuthorized = false;
-            token.clear();
+        if (credentials.isExpired()) {
+            LOG_WARN("Token expired");
+            logout();
             return false;
         }
-        isAuthorized = true;
+        {
+            std::lock_guard lock(monitorMutex);
+            refreshToken = credentials.token;
+            isRefreshRequested = true;
+        }
+        monitorWake.notify_all();
         return true;
     }
 
+    // Render thread, after pollStateChange: acts on what the health monitor published without touching the network.
+    void applyTokenState() {
+        if (isTokenRejected.exchange(false)) logout();
+        else if (isOnline && !isAuthorized) requestTokenValidation();
+    }
+
     bool registerUser(const std::string& username, const std::string& password) {
         if (!isOnline) {
-            std::cout << "No connection to server.\n";
+            LOG_INFO("No connection to server");
             return false;
         }
         return sendPostRequest("/register", {{"username", username}, {"password", password}});
@@ -82,7 +473,7 @@ class ServerClient {
 
     bool loginUser(const std::string& username, const std::string& password) {
         if (!isOnline) {
-            std::cout << "No connection to server.\n";
+            LOG_INFO("No connection to server");
             return false;
         }
         nlohmann::json requestBody = {
@@ -94,84 +485,171 @@ class ServerClient {
             requestBody.dump(), 
             "application/json");
             if (!result) {
-                std::cerr << "Error: no server return." << std::endl;
+                markOffline();
+                LOG_ERROR("Login failed, no response from server");
                 return false;
             }
             if (result->status != 200) {
-                std::cerr << "Authorisation failed. Code: " << result->status << std::endl;
+                LOG_WARN("Authorisation failed", "user", username, "status", result->status);
                 return false;
             }
             try {
                 nlohmann::json response = nlohmann::json::parse(result->body);
                 if (response.contains("token")) {
-                    token = response["token"];
-                    std::cout << "Login success. Token: " << token << std::endl;
-                    isTokenValid();
+                    if (!credentials.save(response["token"].get<std::string>())) LOG_ERROR("Failed to store credentials", "path", credentials.path);
+                    LOG_INFO("Login success", "user", username);
+                    requestTokenValidation();
                     return true;
                 } else {
-                    std::cerr << "Error: No token return!" << std::endl;
+                    LOG_ERROR("Login response has no token", "user", username);
                     return false;
                 }
             } catch (const std::exception& e) {
-                std::cerr << "Failed to parse JSON: " << e.what() << std::endl;
+                LOG_ERROR("Failed to parse login response", "error", e.what());
                 return false;
             }
         return sendPostRequest("/login", {{"username", username}, {"password", password}});
     }
 
-    bool updateUserHighScore(const int& newScore) {
-        if (!isOnline) {
-            std::cout << "No connection to server.\n";
-            return false;
+    // Never blocks: the health monitor thread posts the score, so the caller may be the render loop.
+    void submitScore(int newScore, std::vector<std::uint8_t> replay) {
+        {
+            std::lock_guard lock(monitorMutex);
+            if (pendingScores.size() >= maxPendingScores) {
+                LOG_WARN("Too many scores waiting for the server, dropping the oldest", "score", pendingScores.front().score);
+                pendingScores.erase(pendingScores.begin());
+            }
+            pendingScores.push_back(PendingScore{newScore, std::move(replay)});
         }
-        if (!isTokenValid()) {
-            std::cerr << "Error! Token expired.\n";
-            return false;
+        monitorWake.notify_all();
+    }
+};
+
+class TextPanel : public sf::Drawable, public sf::Transformable {
+    public:
+    const sf::Font& font;
+    unsigned int characterSize;
+    float lineSpacing, letterSpacingFactor;
+    std::vector<std::pair<std::string, sf::Color>> rows;
+
+    TextPanel(const sf::Font& font, unsigned int characterSize, float lineSpacing, float letterSpacingFactor = 1.f) : font{font}, characterSize{characterSize}, lineSpacing{lineSpacing}, letterSpacingFactor{letterSpacingFactor}, vertices{sf::Triangles}, isDirty{true} {}
+
+    void setRowCount(std::size_t count){
+        if (rows.size() != count){
+            rows.resize(count);
+            isDirty = true;
         }
-        nlohmann::json requestBody = {{"score", newScore}};
-        httplib::Result result = client.Post("/update_user_score", {{"Authorization", "Bearer " + token}}, requestBody.dump(), "application/json");
-        return result && result->status == 200;
     }
 
-    std::vector<std::pair<std::string, int>> fetchLeaderboard() {
-        if (!isOnline) {
-            std::cout << "No connection to server.\n";
-            return {};
+    void setRow(std::size_t index, const std::string& str, sf::Color color = sf::Color::White){
+        if (index >= rows.size()) setRowCount(index + 1);
+        auto& row = rows[index];
+        if (row.first != str){
+            row.first = str;
+            isDirty = true;
         }
-        if (!isTokenValid()) {
-            std::cerr << "Error. Token expired. Please login.\n";
-            return {};
+        if (row.second != color){
+            row.second = color;
+            isDirty = true;
         }
-        httplib::Headers headers = {{"Authorization", "Bearer " + token}};
-        httplib::Result result = client.Get("/leaderboard", headers);
-        if (!result || result->status != 200) {
-            std::cerr << "Failed to get leaderboard: " << (result ? std::to_string(result->status) : "No return.") << "\n";
-            return {};
-        }
-        try {
-            nlohmann::json jsonResponse = nlohmann::json::parse(result->body);
-            std::vector<std::pair<std::string, int>> leaderboard;
-            for (const auto& entry : jsonResponse) {
-                std::string username = entry["username"];
-                int score = entry["highscore"];
-                if (score == 0) continue;
-                leaderboard.emplace_back(username, score);
+    }
+
+    private:
+    mutable sf::VertexArray vertices;
+    mutable bool isDirty;
+
+    void rebuild() const {
+        if (!isDirty) return;
+        isDirty = false;
+        vertices.clear();
+        float whitespaceWidth = font.getGlyph(U' ', characterSize, false).advance;
+        float letterSpacing = (whitespaceWidth / 3.f) * (letterSpacingFactor - 1.f);
+        whitespaceWidth += letterSpacing;
+        for (std::size_t i = 0; i < rows.size(); i++){
+            float x = 0.f, y = i * lineSpacing + characterSize;
+            std::uint32_t prevChar = 0;
+            for (unsigned char c : rows[i].first){
+                x += font.getKerning(prevChar, c, characterSize);
+                prevChar = c;
+                if (c == ' '){
+                    x += whitespaceWidth;
+                    continue;
+                }
+                const sf::Glyph& glyph = font.getGlyph(c, characterSize, false);
+                addGlyphQuad(x, y, rows[i].second, glyph);
+                x += glyph.advance + letterSpacing;
             }
-            std::sort(leaderboard.begin(), leaderboard.end(), [](const auto& a, const auto& b) {
-                return a.second > b.second;
-            });
-            return leaderboard;
-        } catch (const std::exception& e) {
-            std::cerr << "Failed to parse JSON: " << e.what() << '\n';
-            return {};
         }
     }
+
+    void addGlyphQuad(float x, float y, sf::Color color, const sf::Glyph& glyph) const {
+        const float padding = 1.f;
+        float left = x + glyph.bounds.left - padding, top = y + glyph.bounds.top - padding;
+        float right = x + glyph.bounds.left + glyph.bounds.width + padding, bottom = y + glyph.bounds.top + glyph.bounds.height + padding;
+        float u1 = glyph.textureRect.left - padding, v1 = glyph.textureRect.top - padding;
+        float u2 = glyph.textureRect.left + glyph.textureRect.width + padding, v2 = glyph.textureRect.top + glyph.textureRect.height + padding;
+        vertices.append(sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u1, v1)));
+        vertices.append(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1)));
+        vertices.append(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2)));
+        vertices.append(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2)));
+        vertices.append(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1)));
+        vertices.append(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u2, v2)));
+    }
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        rebuild();
+        if (vertices.getVertexCount() == 0) return;
+        states.transform *= getTransform();
+        states.texture = &font.getTexture(characterSize);
+        target.draw(vertices, states);
+    }
+};
+
+class ScoreWidget : public sf::Drawable {
+    public:
+    const sf::Texture& strip;
+    const std::array<sf::IntRect, 10>& digitRects;
+    sf::Vector2f origin;
+
+    ScoreWidget(const sf::Texture& strip, const std::array<sf::IntRect, 10>& digitRects, sf::Vector2f origin) : strip{strip}, digitRects{digitRects}, origin{origin}, vertexCount{0}, cachedScore{-1} {}
+
+    void setScore(int score){
+        if (score == cachedScore) return;
+        cachedScore = score;
+        std::array<int, 10> digits;
+        std::size_t digitCount = 0;
+        for (int temp = score; temp > 0 && digitCount < digits.size(); temp /= 10) digits[digitCount++] = temp % 10;
+        float x = origin.x;
+        vertexCount = 0;
+        for (std::size_t i = 0; i < digitCount; i++){
+            const sf::IntRect& rect = digitRects[digits[digitCount - 1 - i]];
+            float left = x + 17.f * i, top = origin.y;
+            float u1 = rect.left, v1 = rect.top, u2 = rect.left + rect.width, v2 = rect.top + rect.height;
+            quads[vertexCount++] = sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(u1, v1));
+            quads[vertexCount++] = sf::Vertex(sf::Vector2f(left + rect.width, top), sf::Vector2f(u2, v1));
+            quads[vertexCount++] = sf::Vertex(sf::Vector2f(left + rect.width, top + rect.height), sf::Vector2f(u2, v2));
+            quads[vertexCount++] = sf::Vertex(sf::Vector2f(left, top + rect.height), sf::Vector2f(u1, v2));
+            x += rect.width;
+        }
+    }
+
+    private:
+    std::array<sf::Vertex, 40> quads;
+    std::size_t vertexCount;
+    int cachedScore;
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        if (vertexCount == 0) return;
+        states.texture = &strip;
+        target.draw(quads.data(), vertexCount, sf::Quads, states);
+    }
 };
 
 class TextInput {
     private:
+    std::string loginCache, passCache;
+
     public:
-    
     sf::Text textLogin;
     sf::Text textPass;
     TextInput(sf::Font& font) {
@@ -188,11 +666,17 @@ class TextInput {
     }
 
     bool text2Login(std::string& inputText){
+        if (inputText == loginCache) return false;
+        loginCache = inputText;
+        SNAKE_ALLOC_SCOPE(AllocTag::Text);
         textLogin.setString(inputText);
         return true;
     }
 
     bool text2Pass(std::string& inputText){
+        if (inputText == passCache) return false;
+        passCache = inputText;
+        SNAKE_ALLOC_SCOPE(AllocTag::Text);
         textPass.setString(inputText);
         return true;
     }
@@ -206,42 +690,183 @@ void closeWindow(sf::RenderWindow& window){
 
 class ConfigManager {
     public:
+    static constexpr int configVersion = 2;
     ServerClient& serverClient;
-    ConfigManager(ServerClient& serverClient) : serverClient{serverClient} {}
+    int loadedVersion;
+    std::vector<std::pair<std::string, std::string>> unknownSettings;
+    std::string lastSaved, saveBuffer;
 
-    void loadSettings(int& musicVolume, int& musicSliderInt, bool& isMusic, int& soundVolume, int& soundSliderInt, bool& isSound, float& moveInterval, int& choseItem){
-        std::ifstream file("cfg.txt");
-        std::string line;
-        if (file.is_open()){
-            while (std::getline(file, line)){
-                if (line.starts_with        ("musicVolume="))       musicVolume = std::stoi(line.substr(12));
-                else if (line.starts_with   ("musicSliderInt="))    musicSliderInt = std::stoi(line.substr(15));
-                else if (line.starts_with   ("isMusic="))           isMusic = std::stoi(line.substr(8));
-                else if (line.starts_with   ("soundVolume="))       soundVolume = std::stoi(line.substr(12));
-                else if (line.starts_with   ("soundSliderInt="))    soundSliderInt = std::stoi(line.substr(15));
-                else if (line.starts_with   ("isSound="))           isSound = std::stoi(line.substr(8));
-                else if (line.starts_with   ("moveInterval="))      moveInterval = std::stof(line.substr(13));
-                else if (line.starts_with   ("choseItem="))         choseItem = std::stoi(line.substr(10));
-                else if (line.starts_with   ("token="))             serverClient.token = line.substr(6);
+    ConfigManager(ServerClient& serverClient) : serverClient{serverClient}, loadedVersion{configVersion} {}
+
+    template <typename T>
+    static bool parseValue(std::string_view str, T& out){
+        T value{};
+        auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+        if (ec != std::errc() || ptr != str.data() + str.size()) return false;
+        out = value;
+        return true;
+    }
+
+    static bool parseValue(std::string_view str, std::string& out){
+        out = str;
+        return true;
+    }
+
+    static bool parseValue(std::string_view str, bool& out){
+        int value;
+        if (!parseValue(str, value) || (value != 0 && value != 1)) return false;
+        out = value;
+        return true;
+    }
+
+    // Returns true when a plaintext token left cfg.txt, so the caller rewrites the file straight away.
+    bool migrateSettings(int& version, std::vector<std::pair<std::string, std::string>>& entries){
+        bool isTokenMoved = false;
+        while (version < configVersion){
+            switch (version){
+                case 0: break; // legacy cfg.txt: same keys, no version line
+                case 1: // token moved to CredentialStore
+                    for (auto it = entries.begin(); it != entries.end(); ){
+                        if (it->first != "token"){
+                            it++;
+                            continue;
+                        }
+                        if (!it->second.empty() && serverClient.credentials.token.empty() && !serverClient.credentials.save(it->second)){
+                            LOG_ERROR("Failed to store credentials, keeping the token in cfg.txt", "path", serverClient.credentials.path);
+                            it++;
+                            continue;
+                        }
+                        it = entries.erase(it);
+                        isTokenMoved = true;
+                    }
+                    break;
             }
-            file.close();
+            version++;
+        }
+        return isTokenMoved;
+    }
+
+    void validateSettings(int& musicVolume, int& musicSliderInt, int& soundVolume, int& soundSliderInt, float& moveInterval, int& choseItem, int& boardWidth, int& boardHeight, int& snakeCount, std::string& netServer, int& netDelayMs){
+        musicVolume = std::clamp(musicVolume, 0, 100);
+        soundVolume = std::clamp(soundVolume, 0, 100);
+        musicSliderInt = std::clamp(musicSliderInt, 0, 332);
+        soundSliderInt = std::clamp(soundSliderInt, 0, 332);
+        if (choseItem < 1 || choseItem > 3) choseItem = 2;
+        if (moveInterval != 0.35f && moveInterval != 0.24f && moveInterval != 0.13f){
+            moveInterval = choseItem == 1 ? 0.35f : choseItem == 2 ? 0.24f : 0.13f;
+        }
+        boardWidth = std::clamp(boardWidth, BoardGrid::minWidth, BoardGrid::maxWidth);
+        boardHeight = std::clamp(boardHeight, BoardGrid::minHeight, BoardGrid::maxHeight);
+        snakeCount = std::clamp(snakeCount, 1, BoardGrid::maxSnakes);
+        std::string host;
+        unsigned short port;
+        if (!netServer.empty() && !NetClient::parseAddress(netServer, host, port)){
+            LOG_WARN("Invalid setting in cfg.txt, using default", "setting", "netServer", "value", netServer);
+            netServer.clear();
         }
+        netDelayMs = std::clamp(netDelayMs, 0, 1000);
+        serverClient.connectTimeoutMs = std::clamp(serverClient.connectTimeoutMs, 100, 60000);
+        serverClient.readTimeoutMs = std::clamp(serverClient.readTimeoutMs, 100, 60000);
     }
 
-    void saveSettings(int& musicVolume, int& musicSliderInt, bool& isMusic, int& soundVolume, int& soundSliderInt, bool& isSound, float& moveInterval, int& choseItem){
-        std::ofstream file("cfg.txt");
+    void loadSettings(int& musicVolume, int& musicSliderInt, bool& isMusic, int& soundVolume, int& soundSliderInt, bool& isSound, float& moveInterval, int& choseItem, int& boardWidth, int& boardHeight, int& snakeCount, std::string& netServer, int& netDelayMs){
+        musicVolume = 100, musicSliderInt = 332, isMusic = true, soundVolume = 100, soundSliderInt = 332, isSound = true, moveInterval = 0.24f, choseItem = 2, boardWidth = 42, boardHeight = 19, snakeCount = 1, netDelayMs = 0;
+        netServer.clear();
+        unknownSettings.clear();
+        std::ifstream file("cfg.txt", std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return;
+        std::string buffer(static_cast<std::size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        file.read(buffer.data(), buffer.size());
+        file.close();
+
+        std::vector<std::pair<std::string, std::string>> entries;
+        loadedVersion = 0;
+        std::string_view view(buffer);
+        while (!view.empty()){
+            std::size_t end = view.find('\n');
+            std::string_view line = view.substr(0, end);
+            view.remove_prefix(end == std::string_view::npos ? view.size() : end + 1);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            std::size_t eq = line.find('=');
+            if (line.empty() || eq == std::string_view::npos) continue;
+            std::string_view key = line.substr(0, eq), value = line.substr(eq + 1);
+            if (key == "version") {
+                if (!parseValue(value, loadedVersion)) loadedVersion = 0;
+            } else entries.emplace_back(key, value);
+        }
+        for (const auto& [key, value] : entries){
+            if (key == "encryptToken" && !parseValue(value, serverClient.credentials.isEncrypted)) LOG_WARN("Invalid setting in cfg.txt, using default", "setting", key);
+        }
+        bool isTokenMoved = loadedVersion < configVersion && migrateSettings(loadedVersion, entries);
+
+        for (const auto& [key, value] : entries){
+            bool known = true, valid = true;
+            if (key == "musicVolume")           valid = parseValue(value, musicVolume);
+            else if (key == "musicSliderInt")   valid = parseValue(value, musicSliderInt);
+            else if (key == "isMusic")          valid = parseValue(value, isMusic);
+            else if (key == "soundVolume")      valid = parseValue(value, soundVolume);
+            else if (key == "soundSliderInt")   valid = parseValue(value, soundSliderInt);
+            else if (key == "isSound")          valid = parseValue(value, isSound);
+            else if (key == "moveInterval")     valid = parseValue(value, moveInterval);
+            else if (key == "choseItem")        valid = parseValue(value, choseItem);
+            else if (key == "boardWidth")       valid = parseValue(value, boardWidth);
+            else if (key == "boardHeight")      valid = parseValue(value, boardHeight);
+            else if (key == "snakeCount")       valid = parseValue(value, snakeCount);
+            else if (key == "netServer")        valid = parseValue(value, netServer);
+            else if (key == "netDelayMs")       valid = parseValue(value, netDelayMs);
+            else if (key == "encryptToken")     continue;
+            else if (key == "connectTimeoutMs") valid = parseValue(value, serverClient.connectTimeoutMs);
+            else if (key == "readTimeoutMs")    valid = parseValue(value, serverClient.readTimeoutMs);
+            else known = false;
+            if (!known) unknownSettings.emplace_back(key, value);
+            else if (!valid) LOG_WARN("Invalid setting in cfg.txt, using default", "setting", key);
+        }
+        validateSettings(musicVolume, musicSliderInt, soundVolume, soundSliderInt, moveInterval, choseItem, boardWidth, boardHeight, snakeCount, netServer, netDelayMs);
+        if (isTokenMoved) saveSettings(musicVolume, musicSliderInt, isMusic, soundVolume, soundSliderInt, isSound, moveInterval, choseItem, boardWidth, boardHeight, snakeCount, netServer, netDelayMs);
+    }
+
+    // Called every frame on SETUP: formats into a reused buffer, so an unchanged config costs no allocation and no write.
+    void saveSettings(int& musicVolume, int& musicSliderInt, bool& isMusic, int& soundVolume, int& soundSliderInt, bool& isSound, float& moveInterval, int& choseItem, int& boardWidth, int& boardHeight, int& snakeCount, std::string& netServer, int& netDelayMs){
+        saveBuffer.clear();
+        appendSetting("version",          std::max(loadedVersion, configVersion));
+        appendSetting("musicVolume",      musicVolume);
+        appendSetting("musicSliderInt",   musicSliderInt);
+        appendSetting("isMusic",          static_cast<int>(isMusic));
+        appendSetting("soundVolume",      soundVolume);
+        appendSetting("soundSliderInt",   soundSliderInt);
+        appendSetting("isSound",          static_cast<int>(isSound));
+        appendSetting("moveInterval",     moveInterval);
+        appendSetting("choseItem",        choseItem);
+        appendSetting("boardWidth",       boardWidth);
+        appendSetting("boardHeight",      boardHeight);
+        appendSetting("snakeCount",       snakeCount);
+        appendSetting("netServer",        std::string_view(netServer));
+        appendSetting("netDelayMs",       netDelayMs);
+        appendSetting("encryptToken",     static_cast<int>(serverClient.credentials.isEncrypted));
+        appendSetting("connectTimeoutMs", serverClient.connectTimeoutMs);
+        appendSetting("readTimeoutMs",    serverClient.readTimeoutMs);
+        for (const auto& [key, value] : unknownSettings) appendSetting(key, std::string_view(value));
+        if (saveBuffer == lastSaved) return;
+        std::ofstream file("cfg.txt", std::ios::binary);
         if (file.is_open()){
-            file << "musicVolume=" <<       musicVolume << "\n";
-            file << "musicSliderInt=" <<    musicSliderInt << "\n";
-            file << "isMusic=" <<           isMusic << "\n";
-            file << "soundVolume=" <<       soundVolume << "\n";
-            file << "soundSliderInt=" <<    soundSliderInt << "\n";
-            file << "isSound=" <<           isSound << "\n";
-            file << "moveInterval=" <<      moveInterval << "\n";
-            file << "choseItem=" <<         choseItem << "\n";
-            file << "token=" <<             serverClient.token << "\n";
+            file.write(saveBuffer.data(), saveBuffer.size());
             file.close();
+            lastSaved = saveBuffer;
+        }
+    }
+
+    private:
+    template <typename T>
+    void appendSetting(std::string_view key, const T& value){
+        saveBuffer.append(key).append("=");
+        if constexpr (std::is_same_v<T, std::string_view>) saveBuffer.append(value);
+        else {
+            char number[32];
+            auto [end, ec] = std::to_chars(number, number + sizeof(number), value);
+            saveBuffer.append(number, ec == std::errc() ? end : number);
         }
+        saveBuffer += '\n';
     }
 };
 
@@ -250,10 +875,10 @@ class AudioManager {
     int soundVolumeI, musicVolumeI;
     sf::Music musicChillGuy, soundUIClick, soundFoodPop;
 
-    AudioManager(){
-        musicChillGuy.openFromFile("assets/audio/ChillGuyTheme.ogg");
-        soundUIClick.openFromFile("assets/audio/ClickStereo.ogg");
-        soundFoodPop.openFromFile("assets/audio/SnesPop.ogg");
+    AudioManager(AssetPack& assets){
+        assets.openStream(musicChillGuy, "assets/audio/ChillGuyTheme.ogg");
+        assets.openStream(soundUIClick, "assets/audio/ClickStereo.ogg");
+        assets.openStream(soundFoodPop, "assets/audio/SnesPop.ogg");
         musicChillGuy.setVolume(0);
     }
 
@@ -289,16 +914,18 @@ class AudioManager {
 
 class UserInterface {    
     public:
-    std::array<sf::Sprite,10> digitSprites;
+    AssetPack& assets;
+    std::array<sf::IntRect,10> digitRects;
+    sf::Texture digitStrip;
     std::array<sf::Sprite,16> blockSprites;
     std::array<sf::Texture,3> preGameTimerTextures;
     sf::Font font;
     sf::Texture background, backgroundm, backgroundmblur, backgroundAYS, textBACK, textBACKpressed, textgoals, textgoalscontain, textquit, textquitcontain, textsetup, textsetupcontain, textstart, textstartcontain, noback, nobackdark, nored, nowhite, yesback, yesbackdark, yesgreen, yeswhite, exit, snakeback, score, zero, one, two, three, four, five, six, seven, eight, nine, locked, inGameSettingsBACK, inGameSettingsBACKpressed, inGameSettingsFRONT, inGameSettingsFRONTcont, block0, block1, block2, block3, block4, block5, block6, block7, block8, block9, block10, block11, block12, block13, block14, block15, CLS, INF, ARC, CLSwhite, INFwhite, ARCwhite, selectmodeBACK, selectsmodesBACK, selectsmodesBACKpressed, textselectmode, selectmodeESC, selectmodeESCcont, selectmodeESCBACK, selectmodeESCBACKpressed, chose0, chose1, chose2, music, musicCont, musicOFF, musicON, sound, soundCont, soundOFF, soundON0, soundON1, soundON2, speedBACK0, speedBACK0pressed, speedBACK1, speedBACK1pressed, speedBACK2, speedBACK2pressed, speedTEXT0, speedTEXT0cont, speedTEXT1, speedTEXT1cont, speedTEXT2, speedTEXT2cont, setupTextBACK, setupTextBACKpressed, textBACKSFXMSC, textBACKSFXMSCpressed, setupback, setupbackCont, backgroundg, resume, resumeCont, GREENbackground, BLUEbackground, PURPLEbackground, REDbackground, ORANGEbackground, YELLOWbackground, BLUEsnakeHead, BLUEsnakeBody, PURPLEsnakeHead, PURPLEsnakeBody, REDsnakeHead, REDsnakeBody, ORANGEsnakeHead, ORANGEsnakeBody, YELLOWsnakeHead, YELLOWsnakeBody, null, textagain, textagaincontain, ARChole, foodextra, wasted, youwon, oneBIGwhite, twoBIGwhite, threeBIGwhite, loginback, loginbackpressed, loginfront, loginfrontcont, logoutback, logoutbackpressed, logoutfront, logoutfrontcont, logreg, textloginBACK, textloginBACKpressed, textlogin, textlogincont, textsignin, textsignincont, logregESC, logregESCcont, logregESCback, logregESCbackpressed, logregback2, textlog, textpass, logregbackno, logregbacknopressed, logregbackyes, logregbackyespressed, reg, regcont, log, logcont, loginbackoffline, loginfrontoffline, textbackoffline, textgoalsoffline;
-    sf::Sprite backgroundSprite, backgroundmSprite, backgroundmblurSprite, backgroundAYSSprite, textBACKSprite1, textBACKSprite2, textBACKSprite3, textBACKSprite4, textBACKpressedSprite1, textBACKpressedSprite2, textBACKpressedSprite3, textBACKpressedSprite4, textgoalsSprite, textgoalscontainSprite, textquitSprite1, textquitSprite2, textquitcontainSprite1, textquitcontainSprite2, textsetupSprite, textsetupcontainSprite, textstartSprite, textstartcontainSprite, nobackSprite, nobackdarkSprite, noredSprite1, noredSprite2, nowhiteSprite1, nowhiteSprite2, yesbackSprite, yesbackdarkSprite, yesgreenSprite, yeswhiteSprite, exitSprite, snakebackSprite, scoreSprite, zeroSprite, oneSprite, twoSprite, threeSprite, fourSprite, fiveSprite, sixSprite, sevenSprite, eightSprite, nineSprite, lockedSprite, inGameSettingsBACKSprite, inGameSettingsBACKpressedSprite, inGameSettingsFRONTSprite, inGameSettingsFRONTcontSprite, block0Sprite, block1Sprite, block2Sprite, block3Sprite, block4Sprite, block5Sprite, block6Sprite, block7Sprite, block8Sprite, block9Sprite, block10Sprite, block11Sprite, block12Sprite, block13Sprite, block14Sprite, block15Sprite, CLSSprite, INFSprite, ARCSprite, CLSwhiteSprite, INFwhiteSprite, ARCwhiteSprite, selectmodeBACKSprite, selectsmodesBACK1Sprite, selectsmodesBACK2Sprite, selectsmodesBACK3Sprite, selectsmodesBACK1pressedSprite, selectmodeESCSprite, selectsmodesBACK2pressedSprite, selectsmodesBACK3pressedSprite, textselectmodeSprite, selectmodeESCcontSprite, selectmodeESCBACKSprite, selectmodeESCBACKpressedSprite, chose0Sprite, chose1Sprite, chose2Sprite, musicSprite, musicContSprite, musicOFFSprite, musicONSprite, soundSprite, soundContSprite, soundOFFSprite, soundON0Sprite, soundON1Sprite, soundON2Sprite, speedBACK0Sprite, speedBACK0pressedSprite, speedBACK1Sprite, speedBACK1pressedSprite, speedBACK2Sprite, speedBACK2pressedSprite, speedTEXT0Sprite, speedTEXT0contSprite, speedTEXT1Sprite, speedTEXT1contSprite, speedTEXT2Sprite, speedTEXT2contSprite, setupTextBACKSprite, setupTextBACKpressedSprite, textBACKSFXMSC0Sprite, textBACKSFXMSC1Sprite, textBACKSFXMSC0pressedSprite, textBACKSFXMSC1pressedSprite, setupbackSprite, setupbackContSprite, backgroundgSprite, resumeSprite , resumeContSprite, GREENbackgroundSprite, BLUEbackgroundSprite, PURPLEbackgroundSprite, REDbackgroundSprite, ORANGEbackgroundSprite, YELLOWbackgroundSprite, BLUEsnakeHeadSprite, BLUEsnakeBodySprite, PURPLEsnakeHeadSprite, PURPLEsnakeBodySprite, REDsnakeHeadSprite, REDsnakeBodySprite, ORANGEsnakeHeadSprite, ORANGEsnakeBodySprite, YELLOWsnakeHeadSprite, YELLOWsnakeBodySprite, nullSprite, textagainSprite, textagaincontainSprite, ARCholeSprite1, ARCholeSprite2, foodextraSprite, wastedSprite, youwonSprite, oneBIGwhiteSprite, twoBIGwhiteSprite, threeBIGwhiteSprite, loginbackSprite, loginbackpressedSprite, loginfrontSprite, loginfrontcontSprite, logoutbackSprite, logoutbackpressedSprite, logoutfrontSprite, logoutfrontcontSprite, logregSprite, textloginBACKSprite, textloginBACKpressedSprite, textloginSprite, textlogincontSprite, textsigninSprite, textsignincontSprite, logregESCSprite, logregESCcontSprite, logregESCbackSprite, logregESCbackpressedSprite, logregback2Sprite, textlogSprite, textpassSprite, logregbacknoSprite, logregbacknopressedSprite, logregbackyesSprite, logregbackyespressedSprite, regSprite, regcontSprite, logSprite, logcontSprite, loginbackofflineSprite, loginfrontofflineSprite, textbackofflineSprite, textgoalsofflineSprite;
+    sf::Sprite backgroundSprite, backgroundmSprite, backgroundmblurSprite, backgroundAYSSprite, textBACKSprite1, textBACKSprite2, textBACKSprite3, textBACKSprite4, textBACKpressedSprite1, textBACKpressedSprite2, textBACKpressedSprite3, textBACKpressedSprite4, textgoalsSprite, textgoalscontainSprite, textquitSprite1, textquitSprite2, textquitcontainSprite1, textquitcontainSprite2, textsetupSprite, textsetupcontainSprite, textstartSprite, textstartcontainSprite, nobackSprite, nobackdarkSprite, noredSprite1, noredSprite2, nowhiteSprite1, nowhiteSprite2, yesbackSprite, yesbackdarkSprite, yesgreenSprite, yeswhiteSprite, exitSprite, snakebackSprite, scoreSprite, zeroSprite, oneSprite, twoSprite, threeSprite, fourSprite, fiveSprite, sixSprite, sevenSprite, eightSprite, nineSprite, lockedSprite, inGameSettingsBACKSprite, inGameSettingsBACKpressedSprite, inGameSettingsFRONTSprite, inGameSettingsFRONTcontSprite, block0Sprite, block1Sprite, block2Sprite, block3Sprite, block4Sprite, block5Sprite, block6Sprite, block7Sprite, block8Sprite, block9Sprite, block10Sprite, block11Sprite, block12Sprite, block13Sprite, block14Sprite, block15Sprite, CLSSprite, INFSprite, ARCSprite, CLSwhiteSprite, INFwhiteSprite, ARCwhiteSprite, selectmodeBACKSprite, selectsmodesBACK1Sprite, selectsmodesBACK2Sprite, selectsmodesBACK3Sprite, selectsmodesBACK1pressedSprite, selectmodeESCSprite, selectsmodesBACK2pressedSprite, selectsmodesBACK3pressedSprite, textselectmodeSprite, selectmodeESCcontSprite, selectmodeESCBACKSprite, selectmodeESCBACKpressedSprite, chose0Sprite, chose1Sprite, chose2Sprite, musicSprite, musicContSprite, musicOFFSprite, musicONSprite, soundSprite, soundContSprite, soundOFFSprite, soundON0Sprite, soundON1Sprite, soundON2Sprite, speedBACK0Sprite, speedBACK0pressedSprite, speedBACK1Sprite, speedBACK1pressedSprite, speedBACK2Sprite, speedBACK2pressedSprite, speedTEXT0Sprite, speedTEXT0contSprite, speedTEXT1Sprite, speedTEXT1contSprite, speedTEXT2Sprite, speedTEXT2contSprite, setupTextBACKSprite, setupTextBACKpressedSprite, textBACKSFXMSC0Sprite, textBACKSFXMSC1Sprite, textBACKSFXMSC0pressedSprite, textBACKSFXMSC1pressedSprite, setupbackSprite, setupbackContSprite, backgroundgSprite, resumeSprite , resumeContSprite, GREENbackgroundSprite, BLUEbackgroundSprite, PURPLEbackgroundSprite, REDbackgroundSprite, ORANGEbackgroundSprite, YELLOWbackgroundSprite, BLUEsnakeHeadSprite, BLUEsnakeBodySprite, PURPLEsnakeHeadSprite, PURPLEsnakeBodySprite, REDsnakeHeadSprite, REDsnakeBodySprite, ORANGEsnakeHeadSprite, ORANGEsnakeBodySprite, YELLOWsnakeHeadSprite, YELLOWsnakeBodySprite, nullSprite, textagainSprite, textagaincontainSprite, ARCholeSprite, foodextraSprite, wastedSprite, youwonSprite, oneBIGwhiteSprite, twoBIGwhiteSprite, threeBIGwhiteSprite, loginbackSprite, loginbackpressedSprite, loginfrontSprite, loginfrontcontSprite, logoutbackSprite, logoutbackpressedSprite, logoutfrontSprite, logoutfrontcontSprite, logregSprite, textloginBACKSprite, textloginBACKpressedSprite, textloginSprite, textlogincontSprite, textsigninSprite, textsignincontSprite, logregESCSprite, logregESCcontSprite, logregESCbackSprite, logregESCbackpressedSprite, logregback2Sprite, textlogSprite, textpassSprite, logregbacknoSprite, logregbacknopressedSprite, logregbackyesSprite, logregbackyespressedSprite, regSprite, regcontSprite, logSprite, logcontSprite, loginbackofflineSprite, loginfrontofflineSprite, textbackofflineSprite, textgoalsofflineSprite;
     int releasedItem, containItem, pressedItem, inGameContain, inGamePressed, inGameReleased, logregReleasedItem;
     bool isGamePaused;
 
-    UserInterface() : releasedItem{0}, containItem {0}, pressedItem{0}, inGameContain{0}, inGamePressed{0}, inGameReleased{0}, logregReleasedItem{0}, isGamePaused{false}{
+    UserInterface(AssetPack& assets) : assets{assets}, releasedItem{0}, containItem {0}, pressedItem{0}, inGameContain{0}, inGamePressed{0}, inGameReleased{0}, logregReleasedItem{0}, isGamePaused{false}{
         Texture2Sprite(background, backgroundSprite, "assets/sprites/background.png", 0, 0);
         Texture2Sprite(backgroundm, backgroundmSprite, "assets/sprites/backgroundm.png", 720, 260);
         Texture2Sprite(backgroundmblur, backgroundmblurSprite, "assets/sprites/backgroundmblur.png", 735, 275);
@@ -438,8 +1065,7 @@ class UserInterface {
         Texture2Sprite(null, nullSprite, "assets/sprites/null.png");
         Texture2Sprite(textagain, textagainSprite, "assets/sprites/textagain.png", 825, 447);
         Texture2Sprite(textagaincontain, textagaincontainSprite, "assets/sprites/textagaincontain.png", 825, 447);
-        Texture2Sprite(ARChole, ARCholeSprite1, "assets/sprites/ARChole.png");
-        Texture2Sprite(ARChole, ARCholeSprite2, "assets/sprites/ARChole.png");
+        Texture2Sprite(ARChole, ARCholeSprite, "assets/sprites/ARChole.png");
         Texture2Sprite(foodextra, foodextraSprite, "assets/sprites/foodextra.png");
         Texture2Sprite(wasted, wastedSprite, "assets/sprites/wasted.png", 777, 322);
         Texture2Sprite(youwon, youwonSprite, "assets/sprites/wasted.png", 759, 322);
@@ -482,9 +1108,7 @@ class UserInterface {
         Texture2Sprite(loginfrontoffline, loginfrontofflineSprite, "assets/sprites/loginfrontoffline.png", 1230, 550);
         
 
-        digitSprites = {
-            zeroSprite, oneSprite, twoSprite, threeSprite, fourSprite, fiveSprite, sixSprite, sevenSprite, eightSprite, nineSprite
-        };
+        buildDigitStrip({&zero, &one, &two, &three, &four, &five, &six, &seven, &eight, &nine});
 
         blockSprites = {
             block0Sprite, block1Sprite, block2Sprite, block3Sprite, block4Sprite, block5Sprite, block6Sprite, block7Sprite, block8Sprite, block9Sprite, block10Sprite, block11Sprite, block12Sprite, block13Sprite, block14Sprite, block15Sprite
@@ -495,40 +1119,196 @@ class UserInterface {
         };
     }
 
+    void buildDigitStrip(const std::array<const sf::Texture*, 10>& digits){
+        unsigned int width = 0, height = 0;
+        for (const sf::Texture* digit : digits){
+            width += digit->getSize().x;
+            height = std::max(height, digit->getSize().y);
+        }
+        sf::Image strip;
+        strip.create(width, height, sf::Color::Transparent);
+        unsigned int x = 0;
+        for (std::size_t i = 0; i < digits.size(); i++){
+            sf::Vector2u size = digits[i]->getSize();
+            strip.copy(digits[i]->copyToImage(), x, 0);
+            digitRects[i] = sf::IntRect(x, 0, size.x, size.y);
+            x += size.x;
+        }
+        digitStrip.loadFromImage(strip);
+        SNAKE_ALLOC_TEXTURE(digitStrip);
+    }
+
     void Texture2Sprite(sf::Texture& texture, sf::Sprite& sprite, std::string str, int posx = 1921, int posy = 1081){
-        texture.loadFromFile(str);
+        assets.load(texture, str);
+        SNAKE_ALLOC_TEXTURE(texture);
         sprite.setTexture(texture);
         sprite.setPosition(posx, posy);
     }
 };
 
+template <typename T>
+class TripleBuffer {
+    public:
+    T& writeBuffer(){
+        return buffers[backIndex];
+    }
+
+    void publish(){
+        backIndex = middle.exchange(backIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    const T& read(){
+        if (middle.load(std::memory_order_acquire) & freshBit) frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & indexMask;
+        return buffers[frontIndex];
+    }
+
+    private:
+    static constexpr std::uint8_t freshBit = 4, indexMask = 3;
+    std::array<T, 3> buffers;
+    std::atomic<std::uint8_t> middle{1};
+    std::uint8_t frontIndex = 0, backIndex = 2;
+};
+
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    public:
+    bool push(const T& value){
+        std::size_t head = writeIndex.load(std::memory_order_relaxed);
+        std::size_t next = (head + 1) % Capacity;
+        if (next == readIndex.load(std::memory_order_acquire)) return false;
+        items[head] = value;
+        writeIndex.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value){
+        std::size_t tail = readIndex.load(std::memory_order_relaxed);
+        if (tail == writeIndex.load(std::memory_order_acquire)) return false;
+        value = items[tail];
+        readIndex.store((tail + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+
+    private:
+    std::array<T, Capacity> items;
+    alignas(64) std::atomic<std::size_t> writeIndex{0};
+    alignas(64) std::atomic<std::size_t> readIndex{0};
+};
+
+struct SnakeView {
+    sf::Vector2i head, direction{1, 0};
+    bool isAlive = true;
+};
+
+struct GameSnapshot {
+    static constexpr int maxSnakes = BoardGrid::maxSnakes;
+    static constexpr std::uint8_t obstacleCell = 255;
+    std::vector<std::uint8_t> visibleBody;
+    std::array<SnakeView, maxSnakes> snakes;
+    std::array<sf::Vector2i, SnakeSim::maxHoles> holes;
+    sf::Vector2i cameraOrigin, foodPos;
+    int snakeCount = 1, holeCount = 0, gameScore = 1, foodInt = 0, snakeInt = 0, backgroundInt = 5;
+    unsigned int levelCount = 0, foodEatenCount = 0;
+    bool isARCModeStarted = false, youWon = false, youLose = false;
+};
+
+struct SimCommand {
+    enum Type { Direction, StartCLS, StartINF, StartARC, Restart, Quit } type;
+    sf::Vector2i direction;
+    std::chrono::steady_clock::time_point pressedAt;
+    int snakeIndex, levelIndex;
+};
+
+struct DirectionInput {
+    sf::Vector2i direction;
+    std::chrono::steady_clock::time_point pressedAt;
+};
+
+template <typename T, std::size_t Capacity>
+class RingBuffer {
+    public:
+    bool push(const T& value){
+        if (count == Capacity) return false;
+        items[(first + count) % Capacity] = value;
+        count++;
+        return true;
+    }
+
+    bool pop(T& value){
+        if (count == 0) return false;
+        value = items[first];
+        first = (first + 1) % Capacity;
+        count--;
+        return true;
+    }
+
+    const T& back() const { return items[(first + count - 1) % Capacity]; }
+    bool empty() const { return count == 0; }
+    void clear() { first = 0, count = 0; }
+
+    private:
+    std::array<T, Capacity> items;
+    std::size_t first = 0, count = 0;
+};
+
+struct InputLatencyStats {
+    std::uint64_t count = 0, dropped = 0;
+    double totalMs = 0.0, maxMs = 0.0;
+
+    void record(std::chrono::steady_clock::duration latency){
+        double ms = std::chrono::duration<double, std::milli>(latency).count();
+        count++;
+        totalMs += ms;
+        maxMs = std::max(maxMs, ms);
+    }
+
+    double averageMs() const { return count ? totalMs / count : 0.0; }
+    void reset() { *this = InputLatencyStats(); }
+};
+
 class SnakeGame {
     public:
     AudioManager& cAudioManager;
     UserInterface& cUserInterface;
     ConfigManager& cConfigManager;
     ServerClient& serverClient;
-    int randX1, randY1, randX2, randY2, randX3, randY3, gameScore, tempGameScore, tempX, tempBounds, snakeInt, backgroundInt, gameOverScore, foodInt;
-    bool isCLSModeStarted, isINFModeStarted, isARCModeStarted, isFoodEaten, isSnakeGrowing, isGameStarted, isNextLevel, youWon, youLose, isGameRestarted, isHoleSpawned, isPreGameTimer;
+    static constexpr int viewWidth = 42, viewHeight = 19;
+    int boardWidth, boardHeight, snakeCount, gameOverScore, netDelayMs, selectedLevel;
+    std::string netServer;
+    unsigned int appliedLevelCount, appliedFoodEatenCount, foodEatenCount;
+    bool isGameStarted, isGameRestarted, isPreGameTimer;
     sf::Texture food, snakeHead, snakeBodyTexture;
-    sf::Sprite foodSprite, snakeHeadSprite, snakeBodySprite, snakeBackgroundSprite;
-    std::deque<sf::Vector2i> snakeBody;
-    sf::Vector2i mSdirection, direction, snakeHeadPos, newSnakePos, foodPos, newHeadPos, holePos1, holePos2;
-    std::vector<int> digitsGS;
+    sf::Sprite foodSprite, snakeBackgroundSprite, obstacleSprite;
+    std::array<sf::Sprite, GameSnapshot::maxSnakes> snakeHeadSprites, snakeBodySprites;
+    LevelPack levelPack;
+    SnakeSim sim;
+    ReplayLog replay;
+    NetClient netClient;
+    std::array<RingBuffer<DirectionInput, 3>, GameSnapshot::maxSnakes> directionInputs;
+    ScoreWidget scoreWidget;
     sf::Clock moveSnakeClock, preGameClock;
     float elapsedTime, moveInterval, preGameElapsed, oneFloat, twoFloat, threeFloat, preGameTimerSpeed, deltaTime;
     std::array<sf::Texture,6> snakeHeadTextures, snakeBodyTextures, snakeBackgroundTextures;
-    sf::IntRect playArea, tempHoleBounds1, tempHoleBounds2, tempFoodBounds, tempSnakeHeadBounds;
-    std::random_device seedGen;
-    std::mt19937 genX1, genY1, genX2, genY2, genX3, genY3;
-    std::uniform_int_distribution<int> distX1, distY1, distX2, distY2, distX3, distY3;
-
-    SnakeGame(UserInterface& UserInterface, AudioManager& AudioManager, ConfigManager& ConfigManager, ServerClient& serverClient) : cAudioManager{AudioManager}, cUserInterface{UserInterface}, cConfigManager{ConfigManager}, serverClient{serverClient}, gameScore{1}, snakeInt{0}, backgroundInt{5}, foodInt{0}, isCLSModeStarted{false}, isINFModeStarted{false}, isARCModeStarted{false}, isFoodEaten{false}, isSnakeGrowing{false}, isGameStarted{false}, isNextLevel{false}, youWon{false}, youLose{false}, isGameRestarted{true}, mSdirection{1, 0}, direction{1, 0}, elapsedTime{0.0f}, preGameElapsed{0.f}, oneFloat{0.f}, twoFloat{0.f}, threeFloat{0.f}, preGameTimerSpeed{1416.f}, playArea{120, 208, 1680, 760}, genX1{seedGen()}, genY1{seedGen()}, genX2{seedGen()}, genY2{seedGen()}, genX3{seedGen()}, genY3{seedGen()}, distX1{0, 41}, distY1{0, 18}, distX2{0, 35}, distY2{0, 12}, distX3{0, 35}, distY3{0, 12} {
-        food.loadFromFile("assets/sprites/food.png");
-        snakeHead.loadFromFile("assets/sprites/snakeHead.png");
-        snakeBodyTexture.loadFromFile("assets/sprites/snakeBody.png");
+    TripleBuffer<GameSnapshot> snapshots;
+    SpscQueue<SimCommand, 64> commands;
+    SpscQueue<PendingScore, 4> finishedGames;
+    InputLatencyStats inputLatency;
+    const GameSnapshot* snapshot;
+    std::atomic<bool> isSimActive, isSimRunning;
+    std::atomic<float> simMoveInterval;
+    std::thread simThread;
+
+    SnakeGame(UserInterface& UserInterface, AudioManager& AudioManager, ConfigManager& ConfigManager, ServerClient& serverClient) : cAudioManager{AudioManager}, cUserInterface{UserInterface}, cConfigManager{ConfigManager}, serverClient{serverClient}, boardWidth{viewWidth}, boardHeight{viewHeight}, snakeCount{1}, gameOverScore{0}, netDelayMs{0}, selectedLevel{-1}, appliedLevelCount{0}, appliedFoodEatenCount{0}, foodEatenCount{0}, isGameStarted{false}, isGameRestarted{true}, isPreGameTimer{false}, scoreWidget{UserInterface.digitStrip, UserInterface.digitRects, sf::Vector2f(450, 112)}, elapsedTime{0.0f}, moveInterval{0.24f}, preGameElapsed{0.f}, oneFloat{0.f}, twoFloat{0.f}, threeFloat{0.f}, preGameTimerSpeed{1416.f}, snapshot{nullptr}, isSimActive{false}, isSimRunning{false}, simMoveInterval{0.24f} {
+        cUserInterface.assets.load(food, "assets/sprites/food.png");
+        cUserInterface.assets.load(snakeHead, "assets/sprites/snakeHead.png");
+        cUserInterface.assets.load(snakeBodyTexture, "assets/sprites/snakeBody.png");
+        SNAKE_ALLOC_TEXTURE(food);
+        SNAKE_ALLOC_TEXTURE(snakeHead);
+        SNAKE_ALLOC_TEXTURE(snakeBodyTexture);
         foodSprite.setTexture(food);
-        spawnFood();
+        obstacleSprite.setTexture(cUserInterface.ARChole);
+        obstacleSprite.setTextureRect(sf::IntRect(80, 80, 40, 40));
+        levelPack.open("assets/levels/levels.pack");
         snakeHeadTextures = {
             snakeHead, cUserInterface.BLUEsnakeHead, cUserInterface.PURPLEsnakeHead, cUserInterface.REDsnakeHead, cUserInterface.ORANGEsnakeHead, cUserInterface.YELLOWsnakeHead
         };
@@ -538,202 +1318,271 @@ class SnakeGame {
         snakeBackgroundTextures = {
             cUserInterface.GREENbackground, cUserInterface.BLUEbackground, cUserInterface.PURPLEbackground, cUserInterface.REDbackground, cUserInterface.ORANGEbackground, cUserInterface.YELLOWbackground
         };
-        snakeHeadPos.x = 20, snakeHeadPos.y = 9;
-        snakeHeadSprite.setTexture(snakeHeadTextures[snakeInt]);
-        snakeBodySprite.setTexture(snakeBodyTextures[snakeInt]);
-        snakeHeadSprite.setPosition((snakeHeadPos.x*40)+120, (snakeHeadPos.y*40)+208);
-        snakeBody.push_back(snakeHeadPos);
+        applySnakeTextures(sim.snakeInt);
         snakeBackgroundSprite.setTexture(cUserInterface.null);
         snakeBackgroundSprite.setPosition(122, 210);
+        publishSnapshot();
+        acquireSnapshot();
     }
 
-    bool holeCollision(){
-        tempHoleBounds1 = sf::IntRect((holePos1.x * 40) + 120, (holePos1.y * 40) + 208, 240, 240);
-        tempHoleBounds2 = sf::IntRect((holePos2.x * 40) + 120, (holePos2.y * 40) + 208, 240, 240);
-        return  tempHoleBounds1.intersects(tempHoleBounds2) ||
-                tempHoleBounds1.intersects(sf::IntRect(920, 568, 40, 40)) ||
-                tempHoleBounds2.intersects(sf::IntRect(920, 568, 40, 40));
+    ~SnakeGame(){
+        stopSimulation();
+        netClient.disconnect();
     }
 
-    void spawnHoles(){
-        if (!isHoleSpawned && isARCModeStarted){
-            do {
-                randX2 = distX2(genX2);
-                randY2 = distY2(genY2);
-                randX3 = distX3(genX3);
-                randY3 = distY3(genY3);
-                holePos1 = sf::Vector2i(randX2, randY2);
-                holePos2 = sf::Vector2i(randX3, randY3);
-            } while (holeCollision() || holePos1 == snakeBody.front() || holePos2 == snakeBody.front());
-            cUserInterface.ARCholeSprite1.setPosition((holePos1.x * 40) + 120, (holePos1.y * 40) + 208);
-            cUserInterface.ARCholeSprite2.setPosition((holePos2.x * 40) + 120, (holePos2.y * 40) + 208);
-            isHoleSpawned = true;
-        }
+    void startSimulation(){
+        isSimRunning = true;
+        simThread = std::thread([this]{
+            SNAKE_ALLOC_SCOPE(AllocTag::Sim);
+            auto nextStep = std::chrono::steady_clock::now();
+            while (isSimRunning.load(std::memory_order_relaxed)){
+                bool isChanged = processCommands();
+                isChanged = gameUpdate(isSimActive.load(std::memory_order_acquire)) || isChanged;
+                if (isChanged) publishSnapshot();
+                nextStep += std::chrono::milliseconds(1);
+                std::this_thread::sleep_until(nextStep);
+            }
+        });
     }
 
-    void gameOver(){
-        gameOverScore = gameScore;
-        std::cout << "Game Over! Score: " << gameOverScore << std::endl;
-        if (isINFModeStarted && serverClient.isAuthorized) {
-            std::cout << "Updating high score...\n";
-            if (!serverClient.updateUserHighScore(gameOverScore)) std::cerr << "Failed to update score.\n";
-            else std::cout << "Score updated successfully.\n";
-        } else std::cerr << "Score not updated: either not in INF mode or not authorized.\n";
+    void stopSimulation(){
+        isSimRunning = false;
+        if (simThread.joinable()) simThread.join();
     }
 
-    bool snakeBodyCollision(){
-        if (std::find(snakeBody.begin() + 1, snakeBody.end(), newSnakePos) != snakeBody.end() && !isNextLevel && snakeBody.size() > 4){
-            youLose = true;
-            return true;
+    void updateSimGate(bool isGamePaused){
+        isSimActive.store(isGameStarted && !isGamePaused && !isPreGameTimer, std::memory_order_release);
+        simMoveInterval.store(moveInterval, std::memory_order_relaxed);
+    }
+
+    void pushCommand(SimCommand::Type type, sf::Vector2i newDirection = sf::Vector2i(), int snakeIndex = 0){
+        if (type != SimCommand::Direction){
+            isPreGameTimer = type != SimCommand::Quit;
+            oneFloat = 1081.f, twoFloat = 1081.f, threeFloat = 1081.f, preGameElapsed = 0.f, deltaTime = 0.f;
+            preGameClock.restart();
         }
-        return false;
+        commands.push(SimCommand{type, newDirection, std::chrono::steady_clock::now(), snakeIndex, selectedLevel});
     }
 
-    void moveSnake(){
-        elapsedTime += moveSnakeClock.restart().asSeconds();
-        if (elapsedTime >= moveInterval || direction != mSdirection){
-            elapsedTime = 0.0f;
-            mSdirection = direction;
-            tempSnakeHeadBounds = sf::IntRect((snakeBody.front().x + mSdirection.x) * 40 + 120, (snakeBody.front().y + mSdirection.y) * 40 + 208, 40, 40);
-            if (isARCModeStarted && !playArea.contains(sf::Vector2i(tempSnakeHeadBounds.left, tempSnakeHeadBounds.top))){
-                if (mSdirection == sf::Vector2i(1, 0)) newSnakePos =        sf::Vector2i(0, snakeBody.front().y);
-                else if (mSdirection == sf::Vector2i(-1, 0)) newSnakePos =  sf::Vector2i(41, snakeBody.front().y);
-                else if (mSdirection == sf::Vector2i(0, 1)) newSnakePos =   sf::Vector2i(snakeBody.front().x, 0);
-                else if (mSdirection == sf::Vector2i(0, -1)) newSnakePos =  sf::Vector2i(snakeBody.front().x, 18);
-            } else if (isARCModeStarted && (tempSnakeHeadBounds.intersects(tempHoleBounds1) || tempSnakeHeadBounds.intersects(tempHoleBounds2))) youLose = true;
-            else if (!isARCModeStarted && !playArea.contains(sf::Vector2i(tempSnakeHeadBounds.left, tempSnakeHeadBounds.top))) youLose = true;
-            else {
-                newSnakePos = snakeBody.front() + mSdirection;
+    void cycleLevel(int step){
+        int choices = static_cast<int>(levelPack.size()) + 1;
+        selectedLevel = (selectedLevel + 1 + step % choices + choices) % choices - 1;
+    }
+
+    std::string_view selectedLevelName() const {
+        return selectedLevel < 0 ? std::string_view("Open board") : levelPack[selectedLevel].name();
+    }
+
+    bool processCommands(){
+        SimCommand command;
+        bool isChanged = false;
+        while (commands.pop(command)){
+            isChanged = true;
+            if (command.type == SimCommand::Direction && netClient.isConnected){
+                if (command.snakeIndex == 0) netClient.queueTurn(command.direction);
+                continue;
             }
-            if (!youLose){
-                sf::Vector2i tempBack = snakeBody.back();
-                if (!isSnakeGrowing) snakeBody.pop_back();
-                else isSnakeGrowing = false;
-                snakeBodyCollision();
-                if (youLose && !isSnakeGrowing) snakeBody.push_back(tempBack);
+            if (command.type == SimCommand::Direction){
+                if (command.snakeIndex < 0 || command.snakeIndex >= static_cast<int>(sim.snakes.size())) continue;
+                const Snake& snake = sim.snakes[command.snakeIndex];
+                RingBuffer<DirectionInput, 3>& inputs = directionInputs[command.snakeIndex];
+                sf::Vector2i lastDirection = inputs.empty() ? snake.direction : inputs.back().direction;
+                if (!snake.isAlive || command.direction == lastDirection || command.direction == -lastDirection) continue;
+                if (!inputs.push(DirectionInput{command.direction, command.pressedAt})) inputLatency.dropped++;
+                continue;
             }
-            if (!youLose) snakeBody.push_front(newSnakePos);
-        }
-    }
-
-    void snakeGrow(){
-        if (snakeBody.front() == foodPos){
-            isFoodEaten = true;
-            if (isARCModeStarted){
-                foodInt++;
-                if (foodInt > 5){
-                    foodInt = 0;
-                    gameScore += 5;
-                    for (int i = 0; i < 4; i++) snakeBody.push_back(snakeBody.back());
-                } else gameScore++;
-            } else gameScore++;
-            if (isINFModeStarted && gameScore % 798 == 0 && gameScore != 0) nextLevel();
-            else {
-                isSnakeGrowing = true;
-                isNextLevel = false;
+            if (!netServer.empty()){
+                if (command.type == SimCommand::Quit) netClient.disconnect();
+                else if (command.type == SimCommand::Restart) netClient.requestRestart();
+                else if (!netClient.isActive()){
+                    netClient.outgoing.delayMs = netDelayMs;
+                    netClient.connect(netServer);
+                }
+                gameOverScore = 0;
+                continue;
             }
+            if (command.type == SimCommand::StartCLS || command.type == SimCommand::StartINF || command.type == SimCommand::StartARC){
+                sim.level = command.levelIndex >= 0 ? levelPack.load(command.levelIndex) : nullptr;
+            }
+            if (command.type == SimCommand::StartCLS) sim.isCLSModeStarted = true;
+            else if (command.type == SimCommand::StartINF) sim.isINFModeStarted = true;
+            else if (command.type == SimCommand::StartARC) sim.isARCModeStarted = true;
+            else if (command.type == SimCommand::Quit) sim.isCLSModeStarted = false, sim.isINFModeStarted = false, sim.isARCModeStarted = false;
+            isGameRestarted = true;
+            restartGame();
+        }
+        return isChanged;
+    }
+
+    void publishSnapshot(){
+        GameSnapshot& next = snapshots.writeBuffer();
+        const SnakeSim& source = netClient.isConnected ? netClient.predicted : sim;
+        const BoardGrid& board = source.board;
+        sf::Vector2i focus, headSum;
+        int aliveCount = 0;
+        next.snakeCount = static_cast<int>(source.snakes.size());
+        for (int i = 0; i < next.snakeCount; i++){
+            const Snake& snake = source.snakes[i];
+            next.snakes[i] = SnakeView{snake.body.front(), snake.direction, snake.isAlive};
+            if (snake.isAlive) headSum += snake.body.front(), aliveCount++;
+        }
+        focus = aliveCount ? sf::Vector2i(headSum.x / aliveCount, headSum.y / aliveCount) : next.snakes[0].head;
+        next.cameraOrigin.x = std::clamp(focus.x - viewWidth / 2, 0, board.width - viewWidth);
+        next.cameraOrigin.y = std::clamp(focus.y - viewHeight / 2, 0, board.height - viewHeight);
+        next.visibleBody.assign(viewWidth * viewHeight, 0);
+        for (int y = 0; y < viewHeight; y++){
+            for (int x = 0; x < viewWidth; x++){
+                sf::Vector2i cell = next.cameraOrigin + sf::Vector2i(x, y);
+                if (board.isOccupied(cell)) next.visibleBody[y * viewWidth + x] = board.ownerAt(cell) + 1;
+                else if (source.level && board.isBlocked(cell)) next.visibleBody[y * viewWidth + x] = GameSnapshot::obstacleCell;
+            }
+        }
+        for (int i = 0; i < next.snakeCount; i++){
+            sf::Vector2i local = next.snakes[i].head - next.cameraOrigin;
+            if (local.x >= 0 && local.y >= 0 && local.x < viewWidth && local.y < viewHeight) next.visibleBody[local.y * viewWidth + local.x] = 0;
+        }
+        next.foodPos = source.foodPos, next.holes = source.holes, next.holeCount = source.placedHoles;
+        next.gameScore = source.gameScore, next.foodInt = source.foodInt, next.snakeInt = source.snakeInt, next.backgroundInt = source.backgroundInt;
+        next.levelCount = source.levelCount, next.foodEatenCount = foodEatenCount;
+        next.isARCModeStarted = source.isARCModeStarted, next.youWon = source.youWon, next.youLose = source.youLose;
+        snapshots.publish();
+    }
+
+    void acquireSnapshot(){
+        snapshot = &snapshots.read();
+        if (snapshot->levelCount != appliedLevelCount){
+            appliedLevelCount = snapshot->levelCount;
+            applySnakeTextures(snapshot->snakeInt);
+            snakeBackgroundSprite.setTexture(snakeBackgroundTextures[snapshot->backgroundInt], true);
+        }
+        if (snapshot->foodEatenCount != appliedFoodEatenCount){
+            appliedFoodEatenCount = snapshot->foodEatenCount;
+            SNAKE_ALLOC_SCOPE(AllocTag::Audio);
             cAudioManager.playSoundFoodPop();
         }
+        foodSprite.setTexture(snapshot->foodInt == ModeRules::bonusFoodEvery ? cUserInterface.foodextra : food);
+        foodSprite.setPosition(cellToScreen(snapshot->foodPos));
+        for (int i = 0; i < snapshot->snakeCount; i++) mSdirectionFunc(snakeHeadSprites[i], snapshot->snakes[i].head, snapshot->snakes[i].direction);
     }
 
-    bool foodCollision(){
-        tempFoodBounds = sf::IntRect((foodPos.x * 40) + 120, (foodPos.y * 40) + 208, 40, 40);
-        return  ((tempFoodBounds.intersects(tempHoleBounds1) || tempFoodBounds.intersects(tempHoleBounds2)) && isARCModeStarted) || 
-                std::find(snakeBody.begin(), snakeBody.end(), foodPos) != snakeBody.end();
+    void applySnakeTextures(int colorInt){
+        for (int i = 0; i < GameSnapshot::maxSnakes; i++){
+            snakeHeadSprites[i].setTexture(snakeHeadTextures[(colorInt + i) % 6]);
+            snakeBodySprites[i].setTexture(snakeBodyTextures[(colorInt + i) % 6]);
+        }
     }
 
-    void spawnFood(){
-        do {
-            randX1 = distX1(genX1);
-            randY1 = distY1(genY1);
-            foodPos = sf::Vector2i(randX1, randY1);
-        } while (foodCollision());
-        isFoodEaten = false;
-        foodSprite.setPosition(120 + (40 * foodPos.x), 208 + (40 * foodPos.y));
+    sf::Vector2f cellToScreen(sf::Vector2i cell) const {
+        return sf::Vector2f(120 + (cell.x - snapshot->cameraOrigin.x) * 40, 208 + (cell.y - snapshot->cameraOrigin.y) * 40);
     }
 
-    void nextLevel(){
-        isNextLevel = true;
-        snakeInt++, backgroundInt++;
-        if (snakeInt > 5) snakeInt = 0;
-        if (backgroundInt > 5) backgroundInt = 0;
-        snakeHeadSprite.setTexture(snakeHeadTextures[snakeInt]);
-        snakeBodySprite.setTexture(snakeBodyTextures[snakeInt]);
-        snakeBackgroundSprite.setTexture(snakeBackgroundTextures[backgroundInt], true);
-        snakeBody.clear();
-        newHeadPos = {
-            static_cast<int>((foodSprite.getPosition().x - 120) / 40),
-            static_cast<int>((foodSprite.getPosition().y - 208) / 40)
-        };
-        snakeBody.push_back(newHeadPos);
-    }
-
-    void gameUpdate(bool& isGamePaused){
-        if (isGameStarted && !isGamePaused && !youLose && !youWon && !isPreGameTimer){
-            snakeGrow();
-            moveSnake();
-            if (foodInt == 5){
-                foodSprite.setTexture(cUserInterface.foodextra);
-            } else foodSprite.setTexture(food);
-            if (isFoodEaten) spawnFood();
-            if (isCLSModeStarted && gameScore == 798){
-                youWon = true;
-            } else if (isARCModeStarted && gameScore == 999){
-                youWon = true;
+    bool isCellVisible(sf::Vector2i cell) const {
+        sf::Vector2i local = cell - snapshot->cameraOrigin;
+        return local.x >= 0 && local.y >= 0 && local.x < viewWidth && local.y < viewHeight;
+    }
+
+    bool placeHoleSprite(sf::Sprite& sprite, sf::Vector2i holePos){
+        sf::IntRect visible;
+        if (!sf::IntRect(holePos.x, holePos.y, SnakeSim::holeSize, SnakeSim::holeSize).intersects(sf::IntRect(snapshot->cameraOrigin.x, snapshot->cameraOrigin.y, viewWidth, viewHeight), visible)) return false;
+        sprite.setTextureRect(sf::IntRect((visible.left - holePos.x) * 40, (visible.top - holePos.y) * 40, visible.width * 40, visible.height * 40));
+        sprite.setPosition(cellToScreen(sf::Vector2i(visible.left, visible.top)));
+        return true;
+    }
+
+    void gameOver(const SnakeSim& result){
+        gameOverScore = result.gameScore;
+        LOG_INFO("Game over", "score", gameOverScore, "snakes", result.snakes.size(), "won", result.youWon);
+        if (result.snakes.size() > 1){
+            for (std::size_t i = 0; i < result.snakes.size(); i++) LOG_INFO("Snake result", "snake", i + 1, "score", result.snakes[i].score);
+        }
+        LOG_DEBUG("Input latency", "avg_ms", inputLatency.averageMs(), "max_ms", inputLatency.maxMs, "turns", inputLatency.count, "dropped", inputLatency.dropped);
+        if (netClient.isConnected) netClient.printStats();
+        if (replay.isRanked() && !netClient.isConnected && !result.level) {
+            LOG_DEBUG("Publishing high score", "score", gameOverScore, "inputs", replay.inputs.size());
+            replay.score = gameOverScore;
+            if (!finishedGames.push(PendingScore{gameOverScore, replay.compress()})) LOG_WARN("Score queue full, score not submitted", "score", gameOverScore);
+        } else LOG_INFO("Score not submitted", "reason", "only solo INF games on the default open board are ranked");
+    }
+
+    // Render thread: the simulation thread never talks to the server, it only publishes finished games here.
+    void submitFinishedGames(){
+        PendingScore finished;
+        while (finishedGames.pop(finished)){
+            if (serverClient.isAuthorized) serverClient.submitScore(finished.score, std::move(finished.replay));
+            else LOG_INFO("Score not submitted", "score", finished.score, "reason", "not authorized");
+        }
+    }
+
+    bool moveSnake(){
+        elapsedTime += moveSnakeClock.restart().asSeconds();
+        if (elapsedTime >= simMoveInterval.load(std::memory_order_relaxed)){
+            elapsedTime = 0.0f;
+            for (std::size_t i = 0; i < sim.snakes.size(); i++){
+                DirectionInput input;
+                if (directionInputs[i].pop(input) && sim.turn(static_cast<int>(i), input.direction)){
+                    inputLatency.record(std::chrono::steady_clock::now() - input.pressedAt);
+                    SNAKE_ALLOC_SCOPE(AllocTag::Replay);
+                    replay.recordTurn(static_cast<int>(i), input.direction);
+                }
             }
-            mSdirectionFunc();
-        } else if (youLose && !gameOverScore){
-            gameOver();
+            replay.recordStep();
+            if (sim.step()) foodEatenCount++;
+            SNAKE_ALLOC_END_TICK();
+            return true;
+        }
+        return false;
+    }
+
+    bool gameUpdate(bool isActive){
+        if (netClient.isActive()){
+            bool isChanged = netClient.update();
+            if (netClient.authoritative.youLose && !gameOverScore) gameOver(netClient.authoritative);
+            else if (!netClient.authoritative.youLose) gameOverScore = 0;
+            return isChanged;
         }
+        if (isActive && !sim.youLose && !sim.youWon){
+            return moveSnake();
+        } else if (sim.youLose && !gameOverScore){
+            gameOver(sim);
+        }
+        return false;
     }
 
-    void mSdirectionFunc(){
-        if (mSdirection == sf::Vector2i(1, 0)){
-            snakeHeadSprite.setRotation(0);
-            snakeHeadSprite.setPosition((snakeBody.front().x*40)+120, (snakeBody.front().y*40)+208);
-        } else if (mSdirection == sf::Vector2i(-1, 0)){
-            snakeHeadSprite.setRotation(-180);
-            snakeHeadSprite.setPosition((snakeBody.front().x*40)+160, (snakeBody.front().y*40)+248);
-        } else if (mSdirection == sf::Vector2i(0, 1)){
-            snakeHeadSprite.setRotation(90);
-            snakeHeadSprite.setPosition((snakeBody.front().x*40)+160, (snakeBody.front().y*40)+208);
-        } else if (mSdirection == sf::Vector2i(0, -1)){
-            snakeHeadSprite.setRotation(-90);
-            snakeHeadSprite.setPosition((snakeBody.front().x*40)+120, (snakeBody.front().y*40)+248);
+    void mSdirectionFunc(sf::Sprite& headSprite, sf::Vector2i head, sf::Vector2i headDirection){
+        sf::Vector2f screenPos = cellToScreen(head);
+        if (headDirection == sf::Vector2i(1, 0)){
+            headSprite.setRotation(0);
+            headSprite.setPosition(screenPos.x, screenPos.y);
+        } else if (headDirection == sf::Vector2i(-1, 0)){
+            headSprite.setRotation(-180);
+            headSprite.setPosition(screenPos.x + 40, screenPos.y + 40);
+        } else if (headDirection == sf::Vector2i(0, 1)){
+            headSprite.setRotation(90);
+            headSprite.setPosition(screenPos.x + 40, screenPos.y);
+        } else if (headDirection == sf::Vector2i(0, -1)){
+            headSprite.setRotation(-90);
+            headSprite.setPosition(screenPos.x, screenPos.y + 40);
         }
     }
 
     void restartGame(){
         if (isGameRestarted){
-            snakeBody.clear();
-            snakeBody.push_back(snakeHeadPos);
-            snakeHeadSprite.setPosition(920, 568);
-            gameScore = 1, elapsedTime = 0.f, snakeInt = 0, backgroundInt = 0, foodInt = 0, oneFloat = 1081.f, twoFloat = 1081.f, threeFloat = 1081.f, preGameElapsed = 0.f, deltaTime = 0.f, gameOverScore = 0;
-            mSdirection = sf::Vector2i(1, 0), direction = sf::Vector2i(1, 0);
-            isNextLevel = false, isFoodEaten = false, isSnakeGrowing = false, youWon = false, youLose = false, isFoodEaten = true, isHoleSpawned = false,
+            sim.boardWidth = boardWidth, sim.boardHeight = boardHeight, sim.snakeCount = snakeCount;
+            std::uint32_t seed = std::random_device{}();
+            sim.reseed(seed);
+            sim.restart();
+            replay.begin(sim, seed);
+            for (RingBuffer<DirectionInput, 3>& inputs : directionInputs) inputs.clear();
+            elapsedTime = 0.f, gameOverScore = 0;
+            inputLatency.reset();
             isGameRestarted = false;
-            spawnHoles();
-            spawnFood();
-            mSdirectionFunc();
-            preGameClock.restart();
-            foodSprite.setTexture(food);
         }
     }
 
     void convertScoreToImage(sf::RenderWindow& window){
-        tempGameScore = gameScore;
-        while(tempGameScore > 0){
-            digitsGS.push_back(tempGameScore % 10);
-            tempGameScore /= 10;
-        }
-        std::reverse(digitsGS.begin(), digitsGS.end());
-        for (std::size_t i = 0; i < digitsGS.size(); i++){
-            cUserInterface.digitSprites[digitsGS[i]].setPosition(450 + (tempBounds + 17 * i), 112);
-            window.draw(cUserInterface.digitSprites[digitsGS[i]]);
-            tempBounds += cUserInterface.digitSprites[digitsGS[i]].getGlobalBounds().width;
-        }
-        tempBounds = 0;
-        digitsGS.clear();
+        SNAKE_ALLOC_SCOPE(AllocTag::Score);
+        scoreWidget.setScore(snapshot->gameScore);
+        window.draw(scoreWidget);
     }
 
     float easyInOut(float t){
@@ -770,7 +1619,9 @@ class SnakeGame {
 class InputManager {
     public:
     bool isLeaderboardLoaded;
-    std::vector<std::pair<std::string, int>> leaderboard;
+    std::size_t leaderboardRevision;
+    unsigned int loadedServerRevision;
+    std::shared_ptr<const LeaderboardTable> leaderboard;
     SnakeGame& cSnakeGame;
     AudioManager& cAudioManager;
     TextInput& textInput;
@@ -782,18 +1633,40 @@ class InputManager {
     sf::Vector2i mousePos;
     sf::Vector2f mouseFloatPos;
     sf::Event fakeEvent;
+    std::array<std::array<sf::Keyboard::Key, 4>, GameSnapshot::maxSnakes> snakeBindings;
+    std::array<sf::Vector2i, 4> bindingDirections;
 
-    InputManager(SnakeGame& SnakeGame, AudioManager& AudioManager, TextInput& textInput, ServerClient& serverClient) : cSnakeGame{SnakeGame}, cAudioManager{AudioManager}, textInput(textInput), serverClient{serverClient}, choseItem{1}, isMusic{true}, isSound{true}, wasGameUnpaused{false}, isTextLActive{false}, isTextRActive{false}, isSent{false}, logoutTriggered{false}, isLeaderboardLoaded{false} {
+    InputManager(SnakeGame& SnakeGame, AudioManager& AudioManager, TextInput& textInput, ServerClient& serverClient) : isLeaderboardLoaded{false}, leaderboardRevision{0}, loadedServerRevision{0}, cSnakeGame{SnakeGame}, cAudioManager{AudioManager}, textInput(textInput), serverClient{serverClient}, choseItem{1}, isMusic{true}, isSound{true}, wasGameUnpaused{false}, isTextLActive{false}, isTextRActive{false}, isSent{false}, logoutTriggered{false} {
         fakeEvent.type = sf::Event::MouseButtonPressed;
         fakeEvent.mouseButton.button = sf::Mouse::Right;
+        snakeBindings = {{
+            {sf::Keyboard::W, sf::Keyboard::S, sf::Keyboard::A, sf::Keyboard::D},
+            {sf::Keyboard::Up, sf::Keyboard::Down, sf::Keyboard::Left, sf::Keyboard::Right},
+            {sf::Keyboard::I, sf::Keyboard::K, sf::Keyboard::J, sf::Keyboard::L},
+            {sf::Keyboard::Numpad8, sf::Keyboard::Numpad5, sf::Keyboard::Numpad4, sf::Keyboard::Numpad6}
+        }};
+        bindingDirections = {sf::Vector2i(0, -1), sf::Vector2i(0, 1), sf::Vector2i(-1, 0), sf::Vector2i(1, 0)};
         handCursor.loadFromSystem(sf::Cursor::Hand);
         defaultCursor.loadFromSystem(sf::Cursor::Arrow);
         textCursor.loadFromSystem(sf::Cursor::Text);
     }
 
+    void onConnectionChanged(){
+        isLeaderboardLoaded = false;
+        serverClient.applyTokenState();
+    }
+
     void loadLeaderboard(){
-        if (!isLeaderboardLoaded) {
-            leaderboard = serverClient.fetchLeaderboard();
+        syncLeaderboard();
+        serverClient.requestLeaderboardRefresh();
+    }
+
+    void syncLeaderboard(){
+        unsigned int revision = serverClient.leaderboardRevision.load();
+        if (!isLeaderboardLoaded || revision != loadedServerRevision) {
+            leaderboard = serverClient.leaderboard();
+            leaderboardRevision++;
+            loadedServerRevision = revision;
             isLeaderboardLoaded = true;
         }
     }
@@ -832,8 +1705,7 @@ class InputManager {
                     cAudioManager.playSoundUIClick();
                     cursorSet = false;
                     if (serverClient.isAuthorized) {
-                        serverClient.isAuthorized = false;
-                        serverClient.token.clear();
+                        serverClient.logout();
                         event = fakeEvent;
                         logoutTriggered = true;
                     } else if (!logoutTriggered) cUserInterface.releasedItem = 6;
@@ -846,20 +1718,20 @@ class InputManager {
             } else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Escape){
                 cAudioManager.playSoundUIClick();
                 cUserInterface.releasedItem = 0;
+            } else if (event.type == sf::Event::KeyReleased && (event.key.code == sf::Keyboard::Left || event.key.code == sf::Keyboard::Right) && !cSnakeGame.levelPack.empty()){
+                cAudioManager.playSoundUIClick();
+                cSnakeGame.cycleLevel(event.key.code == sf::Keyboard::Left ? -1 : 1);
             } else if (cUserInterface.selectsmodesBACK1Sprite.getGlobalBounds().contains(mouseFloatPos)){
                 if (processMouseInput(event, window, &cUserInterface.containItem, 7, &cUserInterface.pressedItem, 7, &cUserInterface.releasedItem, 5, nullptr)){
-                    cSnakeGame.isCLSModeStarted = true, cSnakeGame.isGameRestarted = true, cSnakeGame.isPreGameTimer = true;
-                    cSnakeGame.restartGame();
+                    cSnakeGame.pushCommand(SimCommand::StartCLS);
                 }
             } else if (cUserInterface.selectsmodesBACK2Sprite.getGlobalBounds().contains(mouseFloatPos)){
                 if (processMouseInput(event, window, &cUserInterface.containItem, 8, &cUserInterface.pressedItem, 8, &cUserInterface.releasedItem, 5, nullptr)){
-                    cSnakeGame.isINFModeStarted = true, cSnakeGame.isGameRestarted = true, cSnakeGame.isPreGameTimer = true;
-                    cSnakeGame.restartGame();
+                    cSnakeGame.pushCommand(SimCommand::StartINF);
                 }
             } else if (cUserInterface.selectsmodesBACK3Sprite.getGlobalBounds().contains(mouseFloatPos)){
                 if (processMouseInput(event, window, &cUserInterface.containItem, 9, &cUserInterface.pressedItem, 9, &cUserInterface.releasedItem, 5, nullptr)){
-                    cSnakeGame.isARCModeStarted = true, cSnakeGame.isGameRestarted = true, cSnakeGame.isPreGameTimer = true;
-                    cSnakeGame.restartGame();
+                    cSnakeGame.pushCommand(SimCommand::StartARC);
                 }
             } else if (cUserInterface.selectmodeESCBACKSprite.getGlobalBounds().contains(mouseFloatPos)){
                 processMouseInput(event, window, &cUserInterface.containItem, 10, &cUserInterface.pressedItem, 10, &cUserInterface.releasedItem, 0, nullptr);
@@ -922,9 +1794,8 @@ class InputManager {
                 if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) cUserInterface.releasedItem = 0;
             }
         } else if (cUserInterface.releasedItem == 5){
-            cSnakeGame.isFoodEaten = false;
             cSnakeGame.isGameStarted = true;
-            if (cUserInterface.inGameReleased == 0 && !cSnakeGame.youWon && !cSnakeGame.youLose){
+            if (cUserInterface.inGameReleased == 0 && !cSnakeGame.snapshot->youWon && !cSnakeGame.snapshot->youLose){
                 if (sf::Keyboard::isKeyPressed(sf::Keyboard::Escape) && !wasGameUnpaused){
                     cUserInterface.inGameContain = 1;
                     cUserInterface.inGamePressed = 1;
@@ -1028,7 +1899,7 @@ class InputManager {
                         isSound = !isSound;
                     }
                 }
-            } else if (cSnakeGame.youWon || cSnakeGame.youLose){
+            } else if (cSnakeGame.snapshot->youWon || cSnakeGame.snapshot->youLose){
                 if (cUserInterface.textBACKSprite2.getGlobalBounds().contains(mouseFloatPos)){
                     window.setMouseCursor(handCursor);
                     cursorSet = true;
@@ -1037,8 +1908,8 @@ class InputManager {
                         wlPressedItem = 1;
                     } else if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left){
                         cAudioManager.playSoundUIClick();
-                        cursorSet = false, cSnakeGame.isGameRestarted = true, cSnakeGame.isPreGameTimer = true;
-                        cSnakeGame.restartGame();
+                        cursorSet = false;
+                        cSnakeGame.pushCommand(SimCommand::Restart);
                     }
                 } else if (cUserInterface.textBACKSprite3.getGlobalBounds().contains(mouseFloatPos)){
                     window.setMouseCursor(handCursor);
@@ -1048,9 +1919,9 @@ class InputManager {
                         wlPressedItem = 2;
                     } else if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left){
                         cAudioManager.playSoundUIClick();
-                        cursorSet = false, cSnakeGame.isGameStarted = false, cSnakeGame.isCLSModeStarted = false, cSnakeGame.isINFModeStarted = false, cSnakeGame.isARCModeStarted = false, cSnakeGame.isGameRestarted = true;
+                        cursorSet = false, cSnakeGame.isGameStarted = false;
                         cUserInterface.releasedItem = 0;
-                        cSnakeGame.restartGame();
+                        cSnakeGame.pushCommand(SimCommand::Quit);
                     }
                 }
             }
@@ -1171,10 +2042,11 @@ class InputManager {
         if (!cursorSet) window.setMouseCursor(defaultCursor);
         if (cSnakeGame.isGameStarted && !cUserInterface.isGamePaused){
             if (event.type == sf::Event::KeyPressed){
-                if (event.key.code == sf::Keyboard::W && cSnakeGame.mSdirection != sf::Vector2i(0, 1)) cSnakeGame.direction = sf::Vector2i(0, -1);
-                else if (event.key.code == sf::Keyboard::S && cSnakeGame.mSdirection != sf::Vector2i(0, -1)) cSnakeGame.direction = sf::Vector2i(0, 1);
-                else if (event.key.code == sf::Keyboard::A && cSnakeGame.mSdirection != sf::Vector2i(1, 0)) cSnakeGame.direction = sf::Vector2i(-1, 0);
-                else if (event.key.code == sf::Keyboard::D && cSnakeGame.mSdirection != sf::Vector2i(-1, 0)) cSnakeGame.direction = sf::Vector2i(1, 0);
+                for (int i = 0; i < cSnakeGame.snakeCount; i++){
+                    for (int k = 0; k < 4; k++){
+                        if (event.key.code == snakeBindings[i][k]) cSnakeGame.pushCommand(SimCommand::Direction, bindingDirections[k], i);
+                    }
+                }
             }
         }
     }
@@ -1231,15 +2103,20 @@ class Draw {
     sf::Sprite snakeTempBodySprite;
     sf::Clock unpauseClock;
     sf::Font& font;
+    TextPanel leaderboardPanel;
+    std::size_t leaderboardRevision;
+    sf::Text levelLabel;
+    int levelLabelIndex;
 
-    Draw(ServerClient& serverClient, UserInterface& UserInterface, SnakeGame& SnakeGame, InputManager& InputManager, AudioManager& AudioManager, ConfigManager& ConfigManager, TextInput& textInput, sf::Font& font) : serverClient{serverClient},cUserInterface(UserInterface), cSnakeGame(SnakeGame), cInputManager(InputManager), cAudioManager(AudioManager), cConfigManager{ConfigManager}, textInput{textInput}, soundSlider{1082}, musicSlider{1082}, elapsedTime1{0.f}, isMusicSlider{false}, isSoundSlider{false}, font{font} {
+    Draw(ServerClient& serverClient, UserInterface& UserInterface, SnakeGame& SnakeGame, InputManager& InputManager, AudioManager& AudioManager, ConfigManager& ConfigManager, TextInput& textInput, sf::Font& font) : serverClient{serverClient},cUserInterface(UserInterface), cSnakeGame(SnakeGame), cInputManager(InputManager), cAudioManager(AudioManager), cConfigManager{ConfigManager}, textInput{textInput}, soundSlider{1082}, musicSlider{1082}, elapsedTime1{0.f}, isMusicSlider{false}, isSoundSlider{false}, font{font}, leaderboardPanel{font, 24, 30.f}, leaderboardRevision{0}, levelLabel{"", font, 32}, levelLabelIndex{-2} {
+        leaderboardPanel.setPosition(100, 50);
         cUserInterface.textBACKSFXMSC0pressedSprite.setTextureRect(sf::IntRect(0, 0, musicSliderInt, 105));
         cUserInterface.textBACKSFXMSC1pressedSprite.setTextureRect(sf::IntRect(0, 0, soundSliderInt, 105));
     }
 
     void windowDraw(sf::RenderWindow& window, sf::Event& event){
         window.draw(cUserInterface.backgroundSprite);
-        if ((!cSnakeGame.isGameStarted || cSnakeGame.youLose || cSnakeGame.youWon) && cInputManager.wasGameUnpaused) {
+        if ((!cSnakeGame.isGameStarted || cSnakeGame.snapshot->youLose || cSnakeGame.snapshot->youWon) && cInputManager.wasGameUnpaused) {
             elapsedTime1 = 0.f;
             cInputManager.wasGameUnpaused = false;
             unpauseClock.restart();
@@ -1372,10 +2249,20 @@ class Draw {
             } else {
                 window.draw(cUserInterface.CLSSprite);window.draw(cUserInterface.INFSprite);window.draw(cUserInterface.ARCSprite);window.draw(cUserInterface.selectmodeESCSprite);
             }
+            if (!cSnakeGame.levelPack.empty()){
+                if (levelLabelIndex != cSnakeGame.selectedLevel){
+                    levelLabelIndex = cSnakeGame.selectedLevel;
+                    SNAKE_ALLOC_SCOPE(AllocTag::Text);
+                    levelLabel.setString("< " + std::string(cSnakeGame.selectedLevelName()) + " >");
+                    levelLabel.setPosition(960 - levelLabel.getLocalBounds().width / 2, 780);
+                }
+                window.draw(levelLabel);
+            }
         } else if (cUserInterface.releasedItem == 2){
             setup(window, event);
         } else if (cUserInterface.releasedItem == 3){
-            drawLeaderboard(window, font, cInputManager.leaderboard);
+            cInputManager.syncLeaderboard();
+            if (cInputManager.leaderboard) drawLeaderboard(window, *cInputManager.leaderboard, cInputManager.leaderboardRevision);
         } else if (cUserInterface.releasedItem == 4){
             window.draw(cUserInterface.backgroundmSprite);
             window.draw(cUserInterface.textBACKSprite1);
@@ -1414,17 +2301,25 @@ class Draw {
         } else if (cUserInterface.releasedItem == 5){
             window.draw(cUserInterface.snakebackSprite);
             window.draw(cSnakeGame.snakeBackgroundSprite);
-            if (cSnakeGame.isARCModeStarted){
-                window.draw(cUserInterface.ARCholeSprite1);
-                window.draw(cUserInterface.ARCholeSprite2);
+            if (cSnakeGame.snapshot->isARCModeStarted){
+                for (int i = 0; i < cSnakeGame.snapshot->holeCount; i++){
+                    if (cSnakeGame.placeHoleSprite(cUserInterface.ARCholeSprite, cSnakeGame.snapshot->holes[i])) window.draw(cUserInterface.ARCholeSprite);
+                }
+            }
+            if (cSnakeGame.isCellVisible(cSnakeGame.snapshot->foodPos)) window.draw(cSnakeGame.foodSprite);
+            const GameSnapshot& snapshot = *cSnakeGame.snapshot;
+            for (int y = 0; y < SnakeGame::viewHeight; y++){
+                for (int x = 0; x < SnakeGame::viewWidth; x++){
+                    std::uint8_t owner = snapshot.visibleBody[y * SnakeGame::viewWidth + x];
+                    if (!owner) continue;
+                    snakeTempBodySprite = owner == GameSnapshot::obstacleCell ? cSnakeGame.obstacleSprite : cSnakeGame.snakeBodySprites[owner - 1];
+                    snakeTempBodySprite.setPosition(cSnakeGame.cellToScreen(snapshot.cameraOrigin + sf::Vector2i(x, y)));
+                    window.draw(snakeTempBodySprite);
+                }
             }
-            window.draw(cSnakeGame.foodSprite);
-            for (std::size_t i = 1; i < size(cSnakeGame.snakeBody); i++){
-                snakeTempBodySprite = cSnakeGame.snakeBodySprite;
-                snakeTempBodySprite.setPosition((cSnakeGame.snakeBody[i].x*40)+120, (cSnakeGame.snakeBody[i].y*40)+208);
-                window.draw(snakeTempBodySprite);
+            for (int i = 0; i < snapshot.snakeCount; i++){
+                if (cSnakeGame.isCellVisible(snapshot.snakes[i].head)) window.draw(cSnakeGame.snakeHeadSprites[i]);
             }
-            window.draw(cSnakeGame.snakeHeadSprite);
             window.draw(cUserInterface.scoreSprite);
             cSnakeGame.preGameTimer(window);
             cSnakeGame.convertScoreToImage(window);
@@ -1478,11 +2373,11 @@ class Draw {
                     setup(window, event);
                 }
             }
-            if (cSnakeGame.youLose){
+            if (cSnakeGame.snapshot->youLose){
                 window.draw(cUserInterface.backgroundgSprite);
                 window.draw(cUserInterface.wastedSprite);
                 wlDraw(window);
-            } else if (cSnakeGame.youWon){
+            } else if (cSnakeGame.snapshot->youWon){
                 window.draw(cUserInterface.backgroundgSprite);
                 window.draw(cUserInterface.youwonSprite);
                 wlDraw(window);
@@ -1588,7 +2483,7 @@ class Draw {
         }
     }
 
-    void setup(sf::RenderWindow& window, sf::Event& event){
+    void setup(sf::RenderWindow& window, sf::Event&){
         setupMousePosX = cInputManager.mousePos.x;
         window.draw(cUserInterface.backgroundmSprite);
         cInputManager.cursorSet = false;
@@ -1690,63 +2585,80 @@ class Draw {
         }
         cAudioManager.musicUpdate(cInputManager.isMusic, cAudioManager.musicVolumeI);
         cAudioManager.soundUpdate(cInputManager.isSound, cAudioManager.soundVolumeI);
-        cConfigManager.saveSettings(cAudioManager.musicVolumeI, musicSliderInt, cInputManager.isMusic, cAudioManager.soundVolumeI, soundSliderInt, cInputManager.isSound, cSnakeGame.moveInterval, cInputManager.choseItem);
+        cConfigManager.saveSettings(cAudioManager.musicVolumeI, musicSliderInt, cInputManager.isMusic, cAudioManager.soundVolumeI, soundSliderInt, cInputManager.isSound, cSnakeGame.moveInterval, cInputManager.choseItem, cSnakeGame.boardWidth, cSnakeGame.boardHeight, cSnakeGame.snakeCount, cSnakeGame.netServer, cSnakeGame.netDelayMs);
     }
 
-    void drawLeaderboard(sf::RenderWindow& window, sf::Font& font, const std::vector<std::pair<std::string, int>>& leaderboard) {
-        sf::Text text;
-        text.setFont(font);
-        text.setCharacterSize(24);
-        float startY = 50;
-        for (size_t i = 0; i < leaderboard.size(); i++) {
-            text.setString(std::to_string(i + 1) + ". " + leaderboard[i].first + " - " + std::to_string(leaderboard[i].second));
-            text.setPosition(100, startY + i * 30);
-            if (i == 0) text.setFillColor(sf::Color::Yellow);
-            else if (i == 1) text.setFillColor(sf::Color::Cyan);
-            else if (i == 2) text.setFillColor(sf::Color::Magenta);
-            else text.setFillColor(sf::Color::White);
-            window.draw(text);
+    void drawLeaderboard(sf::RenderWindow& window, const LeaderboardTable& leaderboard, std::size_t revision) {
+        SNAKE_ALLOC_SCOPE(AllocTag::Leaderboard);
+        if (revision != leaderboardRevision) {
+            leaderboardRevision = revision;
+            leaderboardPanel.setRowCount(leaderboard.size());
+            std::string row;
+            leaderboard.formatRows(row, [this](std::size_t i, const std::string& text) {
+                if (i == 0) leaderboardPanel.setRow(i, text, sf::Color::Yellow);
+                else if (i == 1) leaderboardPanel.setRow(i, text, sf::Color::Cyan);
+                else if (i == 2) leaderboardPanel.setRow(i, text, sf::Color::Magenta);
+                else leaderboardPanel.setRow(i, text, sf::Color::White);
+            });
         }
+        window.draw(leaderboardPanel);
     }
 };
 
 class Game {
     public:
     void gameWindow (){
+        SNAKE_ALLOC_SCOPE(AllocTag::Assets);
+        AssetPack assets;
+        assets.open("assets.pack");
         sf::Font font;
-        if (!font.loadFromFile("assets/font/8bitOperatorPlus8-Regular.ttf")) std::cerr << "Failed to load font!\n";
+        if (!assets.load(font, "assets/font/8bitOperatorPlus8-Regular.ttf")) LOG_ERROR("Failed to load font", "path", "assets/font/8bitOperatorPlus8-Regular.ttf");
         ServerClient serverClient;
         TextInput textInput(font);
         ConfigManager cConfigManager(serverClient);
-        AudioManager cAudioManager;
-        UserInterface cUserInterface;
+        AudioManager cAudioManager(assets);
+        UserInterface cUserInterface(assets);
         SnakeGame cSnakeGame(cUserInterface, cAudioManager, cConfigManager, serverClient);
         InputManager cInputManager(cSnakeGame, cAudioManager, textInput, serverClient);
         Draw cDraw(serverClient, cUserInterface, cSnakeGame, cInputManager, cAudioManager, cConfigManager, textInput, font);
-        cConfigManager.loadSettings(cAudioManager.musicVolumeI, cDraw.musicSliderInt, cInputManager.isMusic, cAudioManager.soundVolumeI, cDraw.soundSliderInt, cInputManager.isSound, cSnakeGame.moveInterval, cInputManager.choseItem);
+        cConfigManager.loadSettings(cAudioManager.musicVolumeI, cDraw.musicSliderInt, cInputManager.isMusic, cAudioManager.soundVolumeI, cDraw.soundSliderInt, cInputManager.isSound, cSnakeGame.moveInterval, cInputManager.choseItem, cSnakeGame.boardWidth, cSnakeGame.boardHeight, cSnakeGame.snakeCount, cSnakeGame.netServer, cSnakeGame.netDelayMs);
         cAudioManager.soundUpdate(cInputManager.isSound, cAudioManager.soundVolumeI);
         cAudioManager.musicUpdate(cInputManager.isMusic, cAudioManager.musicVolumeI);
-        serverClient.isTokenValid();
+        serverClient.startHealthMonitor();
         int window_width = 1920;
         int window_height = 1080;
         sf::RenderWindow window(sf::VideoMode(window_width, window_height), "Snake", sf::Style::Default);
         cAudioManager.playMusic();
         sf::Event event;
         window.setFramerateLimit(144);
+        cSnakeGame.startSimulation();
         while (window.isOpen()){
-            cSnakeGame.gameUpdate(cUserInterface.isGamePaused);
+            SNAKE_ALLOC_SCOPE(AllocTag::Render);
+            cSnakeGame.updateSimGate(cUserInterface.isGamePaused);
+            cSnakeGame.acquireSnapshot();
+            cSnakeGame.submitFinishedGames();
+            if (serverClient.pollStateChange()) cInputManager.onConnectionChanged();
             cInputManager.pollEventFunc(window, event, cUserInterface);
             window.clear();
             cDraw.windowDraw(window, event);
             window.display();
+            SNAKE_ALLOC_END_FRAME(cUserInterface.releasedItem);
         }
+        cSnakeGame.stopSimulation();
+        serverClient.stopHealthMonitor();
     }
 };
 
 int main(){
-    if (!SetDllDirectoryA("libs")) std::cerr << "Failed to set DLL directory. Error: " << GetLastError() << std::endl;
-    else std::cout << "DLL directory set to libs/\n";
+    Logger::instance().start("logs/snake.log");
+    if (!Platform::setLibraryDirectory("libs")) LOG_ERROR("Failed to set library directory", "error", Platform::lastError());
     Game Game;
     Game.gameWindow();
+    Logger::instance().stop();
+#if defined(SNAKE_ALLOC_TRACKING)
+    AllocTracker::Budget budget;
+    budget.load("alloc_budget.txt");
+    if (!AllocTracker::report(std::cout, budget)) return 3;
+#endif
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <utility>
+#if defined(_WIN32)
+#include "platform.h"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+class MappedFile {
+    public:
+    MappedFile() : bytes{nullptr}, length{0} {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept : bytes{std::exchange(other.bytes, nullptr)}, length{std::exchange(other.length, 0)} {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other){
+            close();
+            bytes = std::exchange(other.bytes, nullptr), length = std::exchange(other.length, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile(){
+        close();
+    }
+
+    bool open(const std::string& path){
+        close();
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) return false;
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!view) return false;
+        bytes = static_cast<const std::uint8_t*>(view), length = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) return false;
+        struct stat info;
+        void* view = MAP_FAILED;
+        if (fstat(file, &info) == 0 && info.st_size > 0) view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+        if (view == MAP_FAILED) return false;
+        bytes = static_cast<const std::uint8_t*>(view), length = static_cast<std::size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    void close(){
+        if (!bytes) return;
+#if defined(_WIN32)
+        UnmapViewOfFile(bytes);
+#else
+        munmap(const_cast<std::uint8_t*>(bytes), length);
+#endif
+        bytes = nullptr, length = 0;
+    }
+
+    const std::uint8_t* data() const { return bytes; }
+    std::size_t size() const { return length; }
+    bool isOpen() const { return bytes != nullptr; }
+
+    private:
+    const std::uint8_t* bytes;
+    std::size_t length;
+};
+
+// 64-bit FNV-1a, the content hash that level and asset packs store for each entry.
+inline std::uint64_t fnv1aHash(const std::uint8_t* data, std::size_t size){
+    std::uint64_t value = 14695981039346656037ull;
+    for (std::size_t i = 0; i < size; i++) value = (value ^ data[i]) * 1099511628211ull;
+    return value;
+}
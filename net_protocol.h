@@ -0,0 +1,502 @@
+#pragma once
+#include "snake_sim.h"
+#include "byte_stream.h"
+#include "log.h"
+#include <SFML/Network.hpp>
+#include <map>
+#include <string>
+#include <chrono>
+#include <charconv>
+#include <string_view>
+#include <iostream>
+
+struct NetProtocol {
+    enum MessageType : std::uint8_t { Join = 1, Welcome, Input, State, Restart, Leave, Confirm };
+    enum StateField : std::uint8_t { Layout = 1, Food = 2, Score = 4, Colors = 8, Level = 16, Flags = 32 };
+    static constexpr unsigned short defaultPort = 53000;
+    static constexpr std::uint32_t historySize = 64;
+    static constexpr std::uint8_t noInput = 255, spectator = 255;
+    static constexpr int inputRedundancy = 8;
+    // A Join is padded to at least the size of the Welcome it earns, so spoofed Joins cannot amplify traffic.
+    static constexpr std::size_t joinSize = 24;
+
+    static std::uint8_t stepCode(sf::Vector2i from, sf::Vector2i to){
+        sf::Vector2i delta = to - from;
+        if (delta.x > 1) delta.x = -1;
+        else if (delta.x < -1) delta.x = 1;
+        if (delta.y > 1) delta.y = -1;
+        else if (delta.y < -1) delta.y = 1;
+        return SnakeSim::toCode(delta);
+    }
+
+    static sf::Vector2i wrapStep(const BoardGrid& board, sf::Vector2i pos, std::uint8_t code){
+        pos += SnakeSim::toDirection(code);
+        return sf::Vector2i((pos.x + board.width) % board.width, (pos.y + board.height) % board.height);
+    }
+
+    // A decimal port in 1..65535 with nothing after it.
+    static bool parsePort(std::string_view digits, unsigned short& port){
+        unsigned int value = 0;
+        auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+        if (ec != std::errc() || end != digits.data() + digits.size() || value < 1 || value > 65535) return false;
+        port = static_cast<unsigned short>(value);
+        return true;
+    }
+
+    static std::uint32_t nowMs(){
+        return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+struct NetSnakeBaseline {
+    std::uint32_t resetCount = 0, moveCount = 0, length = 0;
+    int score = 0;
+};
+
+struct NetBaseline {
+    std::uint32_t tick = 0;
+    int boardWidth = 0, boardHeight = 0, snakeCount = 0, gameScore = 0, foodInt = 0, snakeInt = 0, backgroundInt = 0;
+    sf::Vector2i foodPos;
+    std::array<sf::Vector2i, SnakeSim::maxHoles> holes;
+    int holeCount = 0;
+    unsigned int levelCount = 0;
+    std::uint8_t flags = 0;
+    bool isHoleSpawned = false;
+    std::array<NetSnakeBaseline, BoardGrid::maxSnakes> snakes;
+
+    static std::uint8_t packFlags(const SnakeSim& sim){
+        return sim.isCLSModeStarted | sim.isINFModeStarted << 1 | sim.isARCModeStarted << 2 | sim.youWon << 3 | sim.youLose << 4 | sim.isNextLevel << 5;
+    }
+
+    static NetBaseline capture(const SnakeSim& sim, std::uint32_t tick){
+        NetBaseline baseline;
+        baseline.tick = tick;
+        baseline.boardWidth = sim.board.width, baseline.boardHeight = sim.board.height, baseline.snakeCount = static_cast<int>(sim.snakes.size());
+        baseline.gameScore = sim.gameScore, baseline.foodInt = sim.foodInt, baseline.snakeInt = sim.snakeInt, baseline.backgroundInt = sim.backgroundInt;
+        baseline.foodPos = sim.foodPos, baseline.holes = sim.holes, baseline.holeCount = sim.placedHoles;
+        baseline.levelCount = sim.levelCount;
+        baseline.flags = packFlags(sim);
+        baseline.isHoleSpawned = sim.isHoleSpawned;
+        for (std::size_t i = 0; i < sim.snakes.size(); i++){
+            const Snake& snake = sim.snakes[i];
+            baseline.snakes[i] = NetSnakeBaseline{snake.resetCount, snake.moveCount, static_cast<std::uint32_t>(snake.body.size()), snake.score};
+        }
+        return baseline;
+    }
+
+    bool hasSameHoles(const NetBaseline& other) const {
+        return isHoleSpawned == other.isHoleSpawned && holeCount == other.holeCount && std::equal(holes.begin(), holes.begin() + holeCount, other.holes.begin());
+    }
+};
+
+class NetStateCodec {
+    public:
+    static void encode(ByteWriter& out, const SnakeSim& sim, const NetBaseline& current, const NetBaseline* base){
+        std::uint8_t mask = 0;
+        if (!base || base->boardWidth != current.boardWidth || base->boardHeight != current.boardHeight || base->snakeCount != current.snakeCount ||
+            !base->hasSameHoles(current)) mask |= NetProtocol::Layout;
+        if (!base || base->foodPos != current.foodPos) mask |= NetProtocol::Food;
+        if (!base || base->gameScore != current.gameScore) mask |= NetProtocol::Score;
+        if (!base || base->foodInt != current.foodInt || base->snakeInt != current.snakeInt || base->backgroundInt != current.backgroundInt) mask |= NetProtocol::Colors;
+        if (!base || base->levelCount != current.levelCount) mask |= NetProtocol::Level;
+        if (!base || base->flags != current.flags) mask |= NetProtocol::Flags;
+        out.u8(mask);
+        if (mask & NetProtocol::Layout){
+            out.varint(current.boardWidth), out.varint(current.boardHeight), out.varint(current.snakeCount);
+            out.u8(current.isHoleSpawned);
+            if (current.isHoleSpawned){
+                out.varint(current.holeCount);
+                for (int i = 0; i < current.holeCount; i++) out.varint(current.holes[i].x), out.varint(current.holes[i].y);
+            }
+        }
+        if (mask & NetProtocol::Food) out.varint(current.foodPos.x), out.varint(current.foodPos.y);
+        if (mask & NetProtocol::Score) out.varint(current.gameScore);
+        if (mask & NetProtocol::Colors) out.u8(current.foodInt), out.u8(current.snakeInt), out.u8(current.backgroundInt);
+        if (mask & NetProtocol::Level) out.varint(current.levelCount);
+        if (mask & NetProtocol::Flags) out.u8(current.flags);
+
+        std::vector<std::uint8_t> codes;
+        for (int i = 0; i < current.snakeCount; i++){
+            const Snake& snake = sim.snakes[i];
+            const NetSnakeBaseline& now = current.snakes[i];
+            std::uint32_t moved = base ? now.moveCount - base->snakes[i].moveCount : 0;
+            bool isFull = !base || (mask & NetProtocol::Layout) || base->snakes[i].resetCount != now.resetCount || moved >= now.length;
+            bool hasScore = !base || base->snakes[i].score != now.score;
+            out.u8(snake.isAlive | snake.isGrowing << 1 | isFull << 2 | hasScore << 3 | SnakeSim::toCode(snake.direction) << 4);
+            if (hasScore) out.varint(now.score);
+            codes.clear();
+            if (isFull){
+                std::uint32_t duplicates = 0;
+                while (duplicates + 1 < now.length && snake.body.at(now.length - 1 - duplicates) == snake.body.at(now.length - 2 - duplicates)) duplicates++;
+                for (std::uint32_t k = 0; k + 1 < now.length - duplicates; k++) codes.push_back(NetProtocol::stepCode(snake.body.at(k), snake.body.at(k + 1)));
+                out.varint(now.resetCount), out.varint(now.moveCount), out.varint(now.length);
+                out.varint(sim.board.toCell(snake.body.front())), out.varint(duplicates);
+            } else {
+                for (std::uint32_t k = moved; k > 0; k--) codes.push_back(NetProtocol::stepCode(snake.body.at(k), snake.body.at(k - 1)));
+                out.varint(base->snakes[i].moveCount), out.varint(moved), out.varint(now.length);
+            }
+            out.codes(codes);
+        }
+    }
+
+    static bool decode(ByteReader& in, SnakeSim& sim, const NetBaseline* base){
+        std::uint8_t mask = in.u8();
+        if (base && !(mask & NetProtocol::Layout) && !hasLayout(sim, *base)) return false;
+        if (base) applyBaseline(sim, *base);
+        if (mask & NetProtocol::Layout){
+            int width = in.varint(), height = in.varint(), snakeCount = in.varint();
+            if (width < BoardGrid::minWidth || width > BoardGrid::maxWidth || height < BoardGrid::minHeight || height > BoardGrid::maxHeight || snakeCount < 1 || snakeCount > BoardGrid::maxSnakes) return false;
+            sim.boardWidth = width, sim.boardHeight = height, sim.snakeCount = snakeCount;
+            sim.resizeBoard();
+            sim.isHoleSpawned = in.u8();
+            sim.placedHoles = 0;
+            if (sim.isHoleSpawned){
+                int holeCount = in.varint();
+                if (holeCount < 0 || holeCount > SnakeSim::maxHoles) return false;
+                for (int i = 0; i < holeCount; i++){
+                    sim.holes[i] = readPos(in);
+                    if (!isHoleInside(sim, sim.holes[i])) return false;
+                    sim.blockHole(sim.holes[i]);
+                }
+                sim.placedHoles = holeCount;
+            }
+        }
+        if (mask & NetProtocol::Food) sim.foodPos = readPos(in);
+        if (mask & NetProtocol::Score) sim.gameScore = in.varint();
+        if (mask & NetProtocol::Colors) sim.foodInt = in.u8(), sim.snakeInt = in.u8(), sim.backgroundInt = in.u8();
+        if (mask & NetProtocol::Level) sim.levelCount = in.varint();
+        if (mask & NetProtocol::Flags) unpackFlags(sim, in.u8());
+        if (!in.isValid || !sim.board.isInside(sim.foodPos)) return false;
+
+        std::vector<std::uint8_t> codes;
+        for (std::size_t i = 0; i < sim.snakes.size(); i++){
+            Snake& snake = sim.snakes[i];
+            std::uint8_t flags = in.u8();
+            snake.isAlive = flags & 1, snake.isGrowing = flags & 2;
+            snake.direction = SnakeSim::toDirection((flags >> 4) & 3);
+            if (flags & 8) snake.score = in.varint();
+            if (flags & 4){
+                std::uint32_t resetCount = in.varint(), moveCount = in.varint(), length = in.varint(), headCell = in.varint(), duplicates = in.varint();
+                if (!in.isValid || length == 0 || length > sim.board.cellCount() || duplicates >= length || headCell >= sim.board.cellCount()) return false;
+                in.codes(codes, length - duplicates - 1);
+                snake.body.clear();
+                sf::Vector2i pos = sim.board.toPos(headCell);
+                snake.body.pushBack(pos);
+                for (std::uint8_t code : codes){
+                    pos = NetProtocol::wrapStep(sim.board, pos, code);
+                    snake.body.pushBack(pos);
+                }
+                for (std::uint32_t k = 0; k < duplicates; k++) snake.body.pushBack(pos);
+                snake.resetCount = resetCount, snake.moveCount = moveCount;
+            } else {
+                std::uint32_t baseMove = in.varint(), moved = in.varint(), length = in.varint();
+                if (!in.isValid || !base || base->snakes[i].resetCount != snake.resetCount || snake.body.empty() || length == 0 || length > sim.board.cellCount() ||
+                    snake.moveCount < baseMove || snake.moveCount > baseMove + moved) return false;
+                in.codes(codes, moved);
+                sf::Vector2i pos = snake.body.front();
+                for (std::uint32_t k = snake.moveCount - baseMove; k < moved; k++){
+                    pos = NetProtocol::wrapStep(sim.board, pos, codes[k]);
+                    snake.body.pushFront(pos);
+                }
+                while (snake.body.size() > length) snake.body.popBack();
+                while (snake.body.size() < length) snake.body.pushBack(snake.body.back());
+                snake.moveCount = baseMove + moved;
+            }
+        }
+        return in.isValid;
+    }
+
+    private:
+    static sf::Vector2i readPos(ByteReader& in){
+        int x = in.varint();
+        int y = in.varint();
+        return sf::Vector2i(x, y);
+    }
+
+    static bool hasLayout(const SnakeSim& sim, const NetBaseline& base){
+        return sim.board.width == base.boardWidth && sim.board.height == base.boardHeight && static_cast<int>(sim.snakes.size()) == base.snakeCount &&
+               sim.isHoleSpawned == base.isHoleSpawned && sim.placedHoles == base.holeCount && std::equal(base.holes.begin(), base.holes.begin() + base.holeCount, sim.holes.begin());
+    }
+
+    static void applyBaseline(SnakeSim& sim, const NetBaseline& base){
+        sim.foodPos = base.foodPos, sim.gameScore = base.gameScore;
+        sim.foodInt = base.foodInt, sim.snakeInt = base.snakeInt, sim.backgroundInt = base.backgroundInt;
+        sim.levelCount = base.levelCount;
+        unpackFlags(sim, base.flags);
+        for (std::size_t i = 0; i < sim.snakes.size(); i++) sim.snakes[i].score = base.snakes[i].score;
+    }
+
+    static void unpackFlags(SnakeSim& sim, std::uint8_t flags){
+        sim.isCLSModeStarted = flags & 1, sim.isINFModeStarted = flags & 2, sim.isARCModeStarted = flags & 4;
+        sim.youWon = flags & 8, sim.youLose = flags & 16, sim.isNextLevel = flags & 32;
+    }
+
+    static bool isHoleInside(const SnakeSim& sim, sf::Vector2i holePos){
+        return holePos.x >= 0 && holePos.y >= 0 && holePos.x + SnakeSim::holeSize <= sim.board.width && holePos.y + SnakeSim::holeSize <= sim.board.height;
+    }
+};
+
+class LatencySimulator {
+    public:
+    int delayMs, jitterMs;
+    float lossRate;
+    std::uint64_t sentBytes, sentPackets, droppedPackets;
+
+    LatencySimulator(sf::UdpSocket& socket) : delayMs{0}, jitterMs{0}, lossRate{0.f}, sentBytes{0}, sentPackets{0}, droppedPackets{0}, socket{socket}, gen{std::random_device{}()} {}
+
+    bool isEnabled() const { return delayMs > 0 || jitterMs > 0 || lossRate > 0.f; }
+
+    void send(const std::vector<std::uint8_t>& data, const sf::IpAddress& address, unsigned short port){
+        sentBytes += data.size(), sentPackets++;
+        if (!isEnabled()){
+            socket.send(data.data(), data.size(), address, port);
+            return;
+        }
+        if (std::uniform_real_distribution<float>(0.f, 1.f)(gen) < lossRate){
+            droppedPackets++;
+            return;
+        }
+        int delay = delayMs + (jitterMs > 0 ? std::uniform_int_distribution<int>(-jitterMs, jitterMs)(gen) : 0);
+        pending.emplace(std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(delay, 0)), Datagram{data, address, port});
+    }
+
+    void flush(){
+        auto now = std::chrono::steady_clock::now();
+        while (!pending.empty() && pending.begin()->first <= now){
+            const Datagram& datagram = pending.begin()->second;
+            socket.send(datagram.data.data(), datagram.data.size(), datagram.address, datagram.port);
+            pending.erase(pending.begin());
+        }
+    }
+
+    private:
+    struct Datagram {
+        std::vector<std::uint8_t> data;
+        sf::IpAddress address;
+        unsigned short port;
+    };
+    sf::UdpSocket& socket;
+    std::mt19937 gen;
+    std::multimap<std::chrono::steady_clock::time_point, Datagram> pending;
+};
+
+class NetClient {
+    public:
+    sf::UdpSocket socket;
+    LatencySimulator outgoing;
+    sf::IpAddress serverAddress;
+    unsigned short serverPort;
+    SnakeSim authoritative, predicted;
+    std::uint32_t authTick, predictedTick, serverTick, nonce;
+    int snakeIndex;
+    float tickInterval, rttMs;
+    bool isConnected, isJoining;
+    std::uint64_t receivedBytes, receivedStates, rejectedStates, rollbackTicks;
+
+    NetClient() : outgoing{socket}, serverPort{NetProtocol::defaultPort}, authTick{0}, predictedTick{0}, serverTick{0}, nonce{0}, snakeIndex{NetProtocol::spectator}, tickInterval{0.24f}, rttMs{0.f}, isConnected{false}, isJoining{false}, receivedBytes{0}, receivedStates{0}, rejectedStates{0}, rollbackTicks{0}, pendingCode{NetProtocol::noInput} {
+        inputTicks.fill(0);
+        inputCodes.fill(NetProtocol::noInput);
+    }
+
+    bool isActive() const { return isConnected || isJoining; }
+
+    // "host" or "host:port", with the port in 1..65535.
+    static bool parseAddress(std::string_view address, std::string& host, unsigned short& port){
+        std::size_t colon = address.rfind(':');
+        host = std::string(address.substr(0, colon));
+        port = NetProtocol::defaultPort;
+        if (host.empty()) return false;
+        if (colon == std::string_view::npos) return true;
+        return NetProtocol::parsePort(address.substr(colon + 1), port);
+    }
+
+    bool connect(const std::string& address){
+        std::string host;
+        if (!parseAddress(address, host, serverPort)){
+            LOG_ERROR("Invalid game server address", "address", address);
+            return false;
+        }
+        serverAddress = sf::IpAddress(host);
+        if (serverAddress == sf::IpAddress::None){
+            LOG_ERROR("Invalid game server address", "address", address);
+            return false;
+        }
+        if (socket.bind(sf::Socket::AnyPort) != sf::Socket::Done){
+            LOG_ERROR("Failed to open game client socket");
+            return false;
+        }
+        socket.setBlocking(false);
+        isJoining = true, isConnected = false;
+        authTick = 0, receivedBytes = 0, receivedStates = 0, rejectedStates = 0, rollbackTicks = 0;
+        sendJoin();
+        return true;
+    }
+
+    void disconnect(){
+        if (!isActive()) return;
+        sendMessage(NetProtocol::Leave);
+        outgoing.flush();
+        printStats();
+        socket.unbind();
+        isConnected = false, isJoining = false;
+    }
+
+    void requestRestart(){
+        sendMessage(NetProtocol::Restart);
+    }
+
+    void queueTurn(sf::Vector2i direction){
+        pendingCode = SnakeSim::toCode(direction);
+    }
+
+    bool update(){
+        bool isChanged = receive();
+        auto now = std::chrono::steady_clock::now();
+        if (isJoining && now - lastJoinAt > std::chrono::milliseconds(500)) sendJoin();
+        if (isConnected){
+            auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(tickInterval));
+            std::uint32_t targetTick = serverTick + leadTicks();
+            if (predictedTick > targetTick + 3) lastTickAt = now;
+            while (now - lastTickAt >= interval){
+                lastTickAt += interval;
+                advance();
+                isChanged = true;
+            }
+            while (predictedTick + 3 < targetTick){
+                advance();
+                isChanged = true;
+            }
+        }
+        outgoing.flush();
+        return isChanged;
+    }
+
+    void printStats() const {
+        LOG_INFO("Game server stats", "states", receivedStates, "bytes_per_tick", receivedStates ? receivedBytes / receivedStates : 0, "rejected", rejectedStates,
+                 "resimulated_ticks", rollbackTicks, "rtt_ms", rttMs);
+    }
+
+    private:
+    std::array<std::uint32_t, NetProtocol::historySize> inputTicks;
+    std::array<std::uint8_t, NetProtocol::historySize> inputCodes;
+    std::array<NetBaseline, NetProtocol::historySize> baselines;
+    std::uint8_t pendingCode;
+    std::chrono::steady_clock::time_point lastTickAt, lastJoinAt;
+    std::array<std::uint8_t, sf::UdpSocket::MaxDatagramSize> receiveBuffer;
+
+    std::uint32_t leadTicks() const {
+        return static_cast<std::uint32_t>(rttMs / 2.f / (tickInterval * 1000.f)) + 1;
+    }
+
+    void sendMessage(NetProtocol::MessageType type){
+        ByteWriter out;
+        out.u8(type);
+        outgoing.send(out.bytes, serverAddress, serverPort);
+    }
+
+    // Until the first state arrives: Join before the Welcome, then Confirm echoing the Welcome's nonce.
+    void sendJoin(){
+        ByteWriter out;
+        if (isConnected){
+            out.u8(NetProtocol::Confirm);
+            out.varint(nonce);
+        } else {
+            out.u8(NetProtocol::Join);
+            while (out.bytes.size() < NetProtocol::joinSize) out.u8(0);
+        }
+        outgoing.send(out.bytes, serverAddress, serverPort);
+        lastJoinAt = std::chrono::steady_clock::now();
+    }
+
+    void sendInputs(){
+        ByteWriter out;
+        out.u8(NetProtocol::Input);
+        out.varint(authTick);
+        out.varint(NetProtocol::nowMs());
+        std::vector<std::uint32_t> ticks;
+        for (std::uint32_t tick = predictedTick; tick > 0 && predictedTick - tick < NetProtocol::inputRedundancy; tick--){
+            std::size_t slot = tick % NetProtocol::historySize;
+            if (inputTicks[slot] == tick && inputCodes[slot] != NetProtocol::noInput && tick > authTick) ticks.push_back(tick);
+        }
+        out.u8(static_cast<std::uint8_t>(ticks.size()));
+        for (std::uint32_t tick : ticks) out.varint(tick), out.u8(inputCodes[tick % NetProtocol::historySize]);
+        outgoing.send(out.bytes, serverAddress, serverPort);
+    }
+
+    void applyInput(SnakeSim& sim, std::uint32_t tick){
+        std::size_t slot = tick % NetProtocol::historySize;
+        if (inputTicks[slot] == tick && inputCodes[slot] != NetProtocol::noInput) sim.turn(snakeIndex, SnakeSim::toDirection(inputCodes[slot]));
+    }
+
+    void advance(){
+        predictedTick++;
+        std::size_t slot = predictedTick % NetProtocol::historySize;
+        inputTicks[slot] = predictedTick, inputCodes[slot] = pendingCode;
+        pendingCode = NetProtocol::noInput;
+        applyInput(predicted, predictedTick);
+        predicted.step();
+        sendInputs();
+    }
+
+    bool receive(){
+        bool isChanged = false;
+        std::size_t received;
+        sf::IpAddress sender;
+        unsigned short senderPort;
+        while (socket.receive(receiveBuffer.data(), receiveBuffer.size(), received, sender, senderPort) == sf::Socket::Done){
+            if (sender != serverAddress || senderPort != serverPort || received == 0) continue;
+            ByteReader in(receiveBuffer.data(), received);
+            std::uint8_t type = in.u8();
+            if (type == NetProtocol::Welcome) handleWelcome(in);
+            else if (type == NetProtocol::State && isConnected){
+                receivedBytes += received;
+                isChanged = handleState(in) || isChanged;
+            }
+        }
+        return isChanged;
+    }
+
+    // The first Welcome answers the Join; the server repeats it with the final snake once the nonce is confirmed.
+    void handleWelcome(ByteReader& in){
+        std::uint8_t index = in.u8();
+        std::uint32_t intervalMs = in.varint(), tick = in.varint(), welcomeNonce = in.varint();
+        if (!in.isValid || !isJoining) return;
+        snakeIndex = index, nonce = welcomeNonce;
+        if (isConnected) return;
+        tickInterval = intervalMs / 1000.f;
+        serverTick = tick, predictedTick = tick, authTick = 0;
+        lastTickAt = std::chrono::steady_clock::now();
+        isConnected = true;
+        if (index == NetProtocol::spectator) LOG_INFO("Joined game server as spectator");
+        else LOG_INFO("Joined game server", "snake", index + 1);
+        sendJoin();
+    }
+
+    bool handleState(ByteReader& in){
+        std::uint32_t tick = in.varint(), baseTick = in.varint(), echoMs = in.varint();
+        if (!in.isValid || tick <= authTick || baseTick > authTick || (baseTick != 0 && authTick == 0)) return false;
+        const NetBaseline* base = nullptr;
+        if (baseTick != 0){
+            base = &baselines[baseTick % NetProtocol::historySize];
+            if (base->tick != baseTick || authTick - baseTick >= NetProtocol::historySize) return false;
+        }
+        if (!NetStateCodec::decode(in, authoritative, base)){
+            rejectedStates++;
+            authTick = 0;
+            return false;
+        }
+        authTick = tick, serverTick = std::max(serverTick, tick);
+        isJoining = false;
+        baselines[tick % NetProtocol::historySize] = NetBaseline::capture(authoritative, tick);
+        receivedStates++;
+        if (echoMs) rttMs = rttMs * 0.9f + (NetProtocol::nowMs() - echoMs) * 0.1f;
+        predicted = authoritative;
+        if (predictedTick < authTick) predictedTick = authTick;
+        for (std::uint32_t replayTick = authTick + 1; replayTick <= predictedTick; replayTick++){
+            applyInput(predicted, replayTick);
+            predicted.step();
+            rollbackTicks++;
+        }
+        return true;
+    }
+};
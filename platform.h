@@ -0,0 +1,61 @@
+#pragma once
+#include <string>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <spawn.h>
+#include <cerrno>
+#include <cstring>
+extern char** environ;
+#endif
+
+class Platform {
+    public:
+    static bool setLibraryDirectory(const std::string& path){
+#if defined(_WIN32)
+        return SetDllDirectoryA(path.c_str()) != 0;
+#else
+        (void)path;
+        return true;
+#endif
+    }
+
+    static std::string executableName(const std::string& name){
+#if defined(_WIN32)
+        return name + ".exe";
+#else
+        return "./" + name;
+#endif
+    }
+
+    static bool launch(const std::string& program){
+#if defined(_WIN32)
+        STARTUPINFOA startup = { sizeof(startup) };
+        PROCESS_INFORMATION process;
+        if (!CreateProcessA(program.c_str(), nullptr, nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startup, &process)) return false;
+        CloseHandle(process.hProcess);
+        CloseHandle(process.hThread);
+        return true;
+#else
+        pid_t process;
+        char* argv[] = {const_cast<char*>(program.c_str()), nullptr};
+        int result = posix_spawn(&process, program.c_str(), nullptr, nullptr, argv, environ);
+        if (result != 0) errno = result;
+        return result == 0;
+#endif
+    }
+
+    static std::string lastError(){
+#if defined(_WIN32)
+        return std::to_string(GetLastError());
+#else
+        return std::strerror(errno);
+#endif
+    }
+};
@@ -0,0 +1,361 @@
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#define CPPHTTPLIB_ZLIB_SUPPORT
+#define CPPHTTPLIB_BROTLI_SUPPORT
+#include "include/httplib.h"
+#include "snake_replay.h"
+#include <nlohmann/json.hpp>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <openssl/pem.h>
+#include <openssl/x509v3.h>
+#include <iostream>
+#include <filesystem>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <csignal>
+
+struct UserRecord {
+    std::string salt, passwordHash;
+    int highscore = 0;
+};
+
+class UserStore {
+    public:
+    int hashIterations;
+    std::atomic<std::uint64_t> revision;
+
+    UserStore() : hashIterations{10000}, revision{1} {}
+
+    bool addUser(const std::string& username, const std::string& password){
+        UserRecord record;
+        record.salt.assign(16, '\0');
+        if (RAND_bytes(reinterpret_cast<unsigned char*>(record.salt.data()), 16) != 1) return false;
+        record.passwordHash = hashPassword(password, record.salt);
+        std::unique_lock lock(mutex);
+        if (!users.emplace(username, std::move(record)).second) return false;
+        revision++;
+        return true;
+    }
+
+    bool checkPassword(const std::string& username, const std::string& password) const {
+        std::string salt, expected;
+        {
+            std::shared_lock lock(mutex);
+            auto it = users.find(username);
+            if (it == users.end()) return false;
+            salt = it->second.salt, expected = it->second.passwordHash;
+        }
+        std::string actual = hashPassword(password, salt);
+        return CRYPTO_memcmp(actual.data(), expected.data(), expected.size()) == 0;
+    }
+
+    bool updateHighscore(const std::string& username, int score){
+        std::unique_lock lock(mutex);
+        auto it = users.find(username);
+        if (it == users.end()) return false;
+        if (score > it->second.highscore){
+            it->second.highscore = score;
+            revision++;
+        }
+        return true;
+    }
+
+    bool hasUser(const std::string& username) const {
+        std::shared_lock lock(mutex);
+        return users.count(username) != 0;
+    }
+
+    nlohmann::json leaderboard(std::uint64_t& snapshotRevision) const {
+        nlohmann::json entries = nlohmann::json::array();
+        std::shared_lock lock(mutex);
+        snapshotRevision = revision;
+        for (const auto& [username, record] : users) entries.push_back({{"username", username}, {"highscore", record.highscore}});
+        return entries;
+    }
+
+    private:
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, UserRecord> users;
+
+    std::string hashPassword(const std::string& password, const std::string& salt) const {
+        std::string hash(32, '\0');
+        PKCS5_PBKDF2_HMAC(password.data(), static_cast<int>(password.size()), reinterpret_cast<const unsigned char*>(salt.data()), static_cast<int>(salt.size()),
+                          hashIterations, EVP_sha256(), 32, reinterpret_cast<unsigned char*>(hash.data()));
+        return hash;
+    }
+};
+
+class TokenSigner {
+    public:
+    int lifetimeSeconds;
+
+    TokenSigner() : lifetimeSeconds{3600}, secret(32, '\0') {
+        RAND_bytes(reinterpret_cast<unsigned char*>(secret.data()), 32);
+    }
+
+    std::string issue(const std::string& username) const {
+        std::int64_t expiry = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() + lifetimeSeconds;
+        std::string header = toBase64Url(R"({"alg":"HS256","typ":"JWT"})");
+        std::string payload = toBase64Url(nlohmann::json{{"sub", username}, {"exp", expiry}}.dump());
+        std::string signingInput = header + "." + payload;
+        return signingInput + "." + toBase64Url(sign(signingInput));
+    }
+
+    bool verify(const std::string& token, std::string& username) const {
+        std::size_t first = token.find('.'), second = token.find('.', first + 1);
+        if (first == std::string::npos || second == std::string::npos) return false;
+        std::string expected = toBase64Url(sign(token.substr(0, second)));
+        std::string_view signature = std::string_view(token).substr(second + 1);
+        if (signature.size() != expected.size() || CRYPTO_memcmp(signature.data(), expected.data(), expected.size()) != 0) return false;
+        std::string payload;
+        if (!fromBase64Url(token.substr(first + 1, second - first - 1), payload)) return false;
+        nlohmann::json claims = nlohmann::json::parse(payload, nullptr, false);
+        if (claims.is_discarded() || !claims.contains("sub") || !claims["sub"].is_string() || !claims.contains("exp") || !claims["exp"].is_number()) return false;
+        std::int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        if (claims["exp"].get<std::int64_t>() <= now) return false;
+        username = claims["sub"].get<std::string>();
+        return true;
+    }
+
+    private:
+    std::string secret;
+
+    std::string sign(const std::string& data) const {
+        unsigned char digest[32];
+        unsigned int length = 0;
+        HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()), reinterpret_cast<const unsigned char*>(data.data()), data.size(), digest, &length);
+        return std::string(reinterpret_cast<char*>(digest), length);
+    }
+
+    static std::string toBase64Url(const std::string& data){
+        std::string out = ReplayLog::toBase64(std::vector<std::uint8_t>(data.begin(), data.end()));
+        while (!out.empty() && out.back() == '=') out.pop_back();
+        for (char& c : out) c = c == '+' ? '-' : c == '/' ? '_' : c;
+        return out;
+    }
+
+    static bool fromBase64Url(std::string text, std::string& out){
+        for (char& c : text) c = c == '-' ? '+' : c == '_' ? '/' : c;
+        while (text.size() % 4 != 0) text += '=';
+        std::vector<std::uint8_t> bytes;
+        if (!ReplayLog::fromBase64(text, bytes)) return false;
+        out.assign(bytes.begin(), bytes.end());
+        return true;
+    }
+};
+
+class ServerStats {
+    public:
+    std::atomic<std::uint64_t> requests{0}, failures{0}, handlerMicros{0}, acceptedReplays{0}, rejectedReplays{0};
+
+    void record(const httplib::Response& response, std::chrono::steady_clock::time_point start){
+        requests++;
+        if (response.status >= 400) failures++;
+        handlerMicros += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void print(double seconds){
+        std::uint64_t count = requests.exchange(0), failed = failures.exchange(0), micros = handlerMicros.exchange(0);
+        if (count == 0) return;
+        std::cout << count / seconds << " req/s, avg handler " << micros / count << " us, " << failed << " errors, replays accepted "
+                  << acceptedReplays.exchange(0) << " rejected " << rejectedReplays.exchange(0) << "\n";
+    }
+};
+
+bool generateCertificate(const std::string& certPath, const std::string& keyPath){
+    EVP_PKEY* key = EVP_RSA_gen(2048);
+    X509* cert = X509_new();
+    bool ok = key && cert;
+    if (ok){
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), static_cast<long>(std::time(nullptr)));
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 365L * 24 * 60 * 60);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        X509V3_CTX ctx;
+        X509V3_set_ctx_nodb(&ctx);
+        X509V3_set_ctx(&ctx, cert, cert, nullptr, nullptr, 0);
+        X509_EXTENSION* altNames = X509V3_EXT_conf_nid(nullptr, &ctx, NID_subject_alt_name, "DNS:localhost,IP:127.0.0.1");
+        X509_EXTENSION* constraints = X509V3_EXT_conf_nid(nullptr, &ctx, NID_basic_constraints, "critical,CA:TRUE");
+        ok = altNames && constraints && X509_add_ext(cert, altNames, -1) && X509_add_ext(cert, constraints, -1) && X509_sign(cert, key, EVP_sha256());
+        X509_EXTENSION_free(altNames);
+        X509_EXTENSION_free(constraints);
+    }
+    if (ok){
+        FILE* keyFile = std::fopen(keyPath.c_str(), "wb");
+        FILE* certFile = std::fopen(certPath.c_str(), "wb");
+        ok = keyFile && certFile && PEM_write_PrivateKey(keyFile, key, nullptr, nullptr, 0, nullptr, nullptr) && PEM_write_X509(certFile, cert);
+        if (keyFile) std::fclose(keyFile);
+        if (certFile) std::fclose(certFile);
+        std::error_code ec;
+        std::filesystem::permissions(keyPath, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write, std::filesystem::perm_options::replace, ec);
+    }
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ok;
+}
+
+bool readBearer(const httplib::Request& request, const TokenSigner& signer, std::string& username){
+    std::string header = request.get_header_value("Authorization");
+    return header.rfind("Bearer ", 0) == 0 && signer.verify(header.substr(7), username);
+}
+
+bool readCredentials(const httplib::Request& request, std::string& username, std::string& password){
+    nlohmann::json body = nlohmann::json::parse(request.body, nullptr, false);
+    if (body.is_discarded() || !body.contains("username") || !body.contains("password") || !body["username"].is_string() || !body["password"].is_string()) return false;
+    username = body["username"].get<std::string>(), password = body["password"].get<std::string>();
+    return !username.empty() && username.size() <= 32 && !password.empty() && password.size() <= 128;
+}
+
+httplib::Server* activeServer = nullptr;
+
+void printUsage(){
+    std::cout << "Usage: reference_server [--port N] [--cert FILE] [--key FILE] [--regenerate-cert] [--threads N]\n"
+                 "                        [--hash-iterations N] [--allow-bare-scores]\n";
+}
+
+int main(int argc, char* argv[]){
+    int port = 8080, threadCount = std::max(4u, std::thread::hardware_concurrency());
+    std::string certPath = "server-cert.pem", keyPath = "server-key.pem";
+    bool isRegenerating = false, isReplayRequired = true;
+    UserStore store;
+    TokenSigner signer;
+    ServerStats stats;
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        try {
+            if (arg == "--regenerate-cert") isRegenerating = true;
+            else if (arg == "--allow-bare-scores") isReplayRequired = false;
+            else if (i + 1 >= argc){
+                printUsage();
+                return 1;
+            }
+            else if (arg == "--port") port = std::stoi(argv[++i]);
+            else if (arg == "--cert") certPath = argv[++i];
+            else if (arg == "--key") keyPath = argv[++i];
+            else if (arg == "--threads") threadCount = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--hash-iterations") store.hashIterations = std::max(1, std::stoi(argv[++i]));
+            else {
+                printUsage();
+                return 1;
+            }
+        } catch (const std::exception&){
+            std::cerr << "Invalid value for " << arg << "\n";
+            return 1;
+        }
+    }
+
+    if (isRegenerating || (!std::filesystem::exists(certPath) && !std::filesystem::exists(keyPath))){
+        if (!generateCertificate(certPath, keyPath)){
+            std::cerr << "Failed to generate a self-signed certificate.\n";
+            return 1;
+        }
+        std::cout << "Generated self-signed certificate " << certPath << " and key " << keyPath << "\n";
+    } else if (!std::filesystem::exists(keyPath)){
+        std::cerr << certPath << " exists without " << keyPath << ". Pass --regenerate-cert to replace it, or --cert/--key to use another pair.\n";
+        return 1;
+    }
+
+    httplib::SSLServer server(certPath.c_str(), keyPath.c_str());
+    if (!server.is_valid()){
+        std::cerr << "Failed to load " << certPath << " / " << keyPath << "\n";
+        return 1;
+    }
+    server.new_task_queue = [threadCount]{ return new httplib::ThreadPool(threadCount); };
+
+    server.Get("/", [&](const httplib::Request&, httplib::Response& response){
+        response.set_content("ok", "text/plain");
+    });
+
+    server.Post("/register", [&](const httplib::Request& request, httplib::Response& response){
+        auto start = std::chrono::steady_clock::now();
+        std::string username, password;
+        if (!readCredentials(request, username, password)) response.status = 400;
+        else if (!store.addUser(username, password)) response.status = 409;
+        else response.set_content(R"({"status":"registered"})", "application/json");
+        stats.record(response, start);
+    });
+
+    server.Post("/login", [&](const httplib::Request& request, httplib::Response& response){
+        auto start = std::chrono::steady_clock::now();
+        std::string username, password;
+        if (!readCredentials(request, username, password)) response.status = 400;
+        else if (!store.checkPassword(username, password)) response.status = 401;
+        else response.set_content(nlohmann::json{{"token", signer.issue(username)}}.dump(), "application/json");
+        stats.record(response, start);
+    });
+
+    server.Get("/leaderboard", [&](const httplib::Request& request, httplib::Response& response){
+        auto start = std::chrono::steady_clock::now();
+        std::string username;
+        std::string etag = "\"" + std::to_string(store.revision) + "\"";
+        if (!readBearer(request, signer, username) || !store.hasUser(username)) response.status = 401;
+        else if (request.get_header_value("If-None-Match") == etag){
+            response.status = 304;
+            response.set_header("ETag", etag);
+        } else {
+            std::uint64_t revision;
+            std::string body = store.leaderboard(revision).dump();
+            response.set_header("ETag", "\"" + std::to_string(revision) + "\"");
+            response.set_content(body, "application/json");
+        }
+        stats.record(response, start);
+    });
+
+    server.Post("/update_user_score", [&](const httplib::Request& request, httplib::Response& response){
+        auto start = std::chrono::steady_clock::now();
+        std::string username;
+        nlohmann::json body = nlohmann::json::parse(request.body, nullptr, false);
+        if (!readBearer(request, signer, username)) response.status = 401;
+        else if (body.is_discarded() || !body.contains("score") || !body["score"].is_number_integer()) response.status = 400;
+        else if (body.contains("replay") && body["replay"].is_string()){
+            thread_local ReplayVerifier verifier;
+            thread_local ReplayLog replay;
+            std::vector<std::uint8_t> data;
+            ReplayVerifier::Result result = ReplayVerifier::Malformed;
+            if (ReplayLog::fromBase64(body["replay"].get<std::string>(), data) && replay.decompress(data.data(), data.size())){
+                if (!replay.isRanked()) result = ReplayVerifier::Unranked;
+                else result = replay.score != body["score"].get<int>() ? ReplayVerifier::ScoreMismatch : verifier.verify(replay);
+            }
+            if (result == ReplayVerifier::Accepted){
+                stats.acceptedReplays++;
+                store.updateHighscore(username, replay.score);
+            } else {
+                stats.rejectedReplays++;
+                response.status = 422;
+                response.set_content(nlohmann::json{{"error", ReplayVerifier::describe(result)}}.dump(), "application/json");
+            }
+        } else if (isReplayRequired){
+            response.status = 422;
+            response.set_content(R"({"error":"replay required"})", "application/json");
+        } else store.updateHighscore(username, body["score"].get<int>());
+        stats.record(response, start);
+    });
+
+    activeServer = &server;
+    std::signal(SIGINT, [](int){ if (activeServer) activeServer->stop(); });
+    std::atomic<bool> isRunning{true};
+    std::thread reporter([&]{
+        auto last = std::chrono::steady_clock::now();
+        while (isRunning){
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            auto now = std::chrono::steady_clock::now();
+            if (now - last < std::chrono::seconds(5)) continue;
+            stats.print(std::chrono::duration<double>(now - last).count());
+            last = now;
+        }
+    });
+    std::cout << "Reference server listening on https://localhost:" << port << " with " << threadCount << " worker threads\n";
+    bool isListening = server.listen("127.0.0.1", port);
+    isRunning = false;
+    reporter.join();
+    if (!isListening){
+        std::cerr << "Failed to listen on port " << port << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,333 @@
+#pragma once
+#include "snake_board.h"
+#include "snake_modes.h"
+#include "hole_placement.h"
+#include <iostream>
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+struct BatchRng {
+    using result_type = std::uint64_t;
+    std::uint64_t state = 0;
+
+    void seed(std::uint64_t value){ state = value; }
+    static constexpr result_type min(){ return 0; }
+    static constexpr result_type max(){ return ~result_type(0); }
+
+    result_type operator()(){
+        std::uint64_t z = state += 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+template <typename Rng = BatchRng>
+class SnakeBatch {
+    public:
+    enum Mode : std::uint8_t { CLS, INF, ARC };
+    enum Status : std::uint8_t { Running, Lost, Won };
+    enum Hazard : std::int32_t { HitWall = 1, HitBlock = 2, HitFood = 4 };
+    static constexpr int holeSize = 6, maxCells = 65536;
+    std::size_t gameCount;
+    int width, height, cellCount, wordCount;
+    Mode mode;
+    bool useSimd;
+    std::vector<std::int32_t> headX, headY, dirX, dirY, foodCell, gameScore, foodInt, reward;
+    std::vector<std::int32_t> nextX, nextY, nextCell, hazard;
+    std::vector<std::uint8_t> status, isGrowing, isNextLevel;
+    std::vector<std::uint32_t> bodyHead, bodyCount, freeCount, occupied, blocked;
+    std::vector<std::uint16_t> body, freeCells, freeIndex;
+    std::vector<Rng> foodRng;
+    HolePlacer holePlacer;
+
+    SnakeBatch(std::size_t count, int newWidth, int newHeight, Mode newMode) : gameCount{count}, mode{newMode}, useSimd{true} {
+        width = std::clamp(newWidth, BoardGrid::minWidth, BoardGrid::maxWidth);
+        height = std::clamp(newHeight, BoardGrid::minHeight, BoardGrid::maxHeight);
+        if (width * height > maxCells){
+            height = maxCells / width;
+            std::cerr << "Batch boards are limited to " << maxCells << " cells, using " << width << "x" << height << "\n";
+        }
+        cellCount = width * height, wordCount = (cellCount + 31) / 32;
+        for (auto* lane : {&headX, &headY, &dirX, &dirY, &foodCell, &gameScore, &foodInt, &reward, &nextX, &nextY, &nextCell, &hazard}) lane->assign(gameCount, 0);
+        status.assign(gameCount, Lost), isGrowing.assign(gameCount, 0), isNextLevel.assign(gameCount, 0);
+        bodyHead.assign(gameCount, 0), bodyCount.assign(gameCount, 0), freeCount.assign(gameCount, 0);
+        occupied.assign(gameCount * wordCount, 0), blocked.assign(gameCount * wordCount, 0);
+        body.assign(gameCount * cellCount, 0), freeCells.assign(gameCount * cellCount, 0), freeIndex.assign(gameCount * cellCount, 0);
+        foodRng.resize(gameCount);
+        if (mode == ARC) holePlacer = HolePlacer(width, height, {HoleShape{holeSize, holeSize}, HoleShape{holeSize, holeSize}}, {sf::Vector2i(width / 2 - 1, height / 2)});
+        for (std::size_t game = 0; game < gameCount; game++) reset(game, static_cast<std::uint32_t>(game));
+    }
+
+    static const char* simdPath(){
+#if defined(__AVX2__)
+        return "AVX2";
+#elif defined(__SSE4_1__)
+        return "SSE4.1";
+#else
+        return "scalar";
+#endif
+    }
+
+    std::size_t bytesPerGame() const {
+        return sizeof(std::int32_t) * 12 + 3 + sizeof(std::uint32_t) * (3 + 2 * wordCount) + sizeof(std::uint16_t) * 3 * cellCount + sizeof(Rng);
+    }
+
+    void reset(std::size_t game, std::uint32_t seed){
+        std::fill_n(occupied.begin() + game * wordCount, wordCount, 0u);
+        std::fill_n(blocked.begin() + game * wordCount, wordCount, 0u);
+        std::uint16_t* cells = freeCells.data() + game * cellCount;
+        std::uint16_t* index = freeIndex.data() + game * cellCount;
+        for (int cell = 0; cell < cellCount; cell++) cells[cell] = index[cell] = static_cast<std::uint16_t>(cell);
+        freeCount[game] = cellCount;
+        bodyHead[game] = 0, bodyCount[game] = 0;
+        headX[game] = width / 2 - 1, headY[game] = height / 2;
+        pushBack(game, headY[game] * width + headX[game]);
+        dirX[game] = 1, dirY[game] = 0;
+        gameScore[game] = 1, foodInt[game] = 0, reward[game] = 0;
+        isGrowing[game] = 0, isNextLevel[game] = 0;
+        status[game] = Running;
+        foodRng[game].seed(seed);
+        withMode([&](auto rules){ if (rules.hasHoles) spawnHoles(game, seed); });
+        spawnFood(game);
+    }
+
+    bool turn(std::size_t game, std::uint8_t code){
+        static constexpr std::int32_t codeX[4] = {0, 0, -1, 1}, codeY[4] = {-1, 1, 0, 0};
+        if (game >= gameCount || code > 3 || status[game] != Running) return false;
+        if (codeX[code] == -dirX[game] && codeY[code] == -dirY[game]) return false;
+        dirX[game] = codeX[code], dirY[game] = codeY[code];
+        return true;
+    }
+
+    void step(){
+        step(0, gameCount);
+    }
+
+    void step(std::size_t first, std::size_t last){
+        withMode([&](auto rules){ stepAs(rules, first, last); });
+    }
+
+    void stepFlagDriven(){
+        stepAs(RuntimeMode::fromFlags(mode == CLS, mode == INF, mode == ARC), 0, gameCount);
+    }
+
+    template <typename Fn>
+    decltype(auto) withMode(Fn&& fn){
+        if (mode == ARC) return fn(ArcadeMode{});
+        if (mode == INF) return fn(InfiniteMode{});
+        return fn(ClassicMode{});
+    }
+
+    template <typename Rules>
+    void stepAs(const Rules& rules, std::size_t first, std::size_t last){
+        last = std::min(last, gameCount);
+        std::fill(reward.begin() + first, reward.begin() + last, 0);
+        computeMoves(rules, first, last);
+        for (std::size_t game = first; game < last; game++){
+            if (status[game] == Running) commit(rules, game);
+        }
+    }
+
+    bool isOccupied(std::size_t game, std::uint32_t cell) const { return occupied[game * wordCount + (cell >> 5)] >> (cell & 31) & 1; }
+    bool isBlocked(std::size_t game, std::uint32_t cell) const { return blocked[game * wordCount + (cell >> 5)] >> (cell & 31) & 1; }
+    std::uint32_t bodyAt(std::size_t game, std::size_t index) const {
+        return body[game * cellCount + (bodyHead[game] + index) % cellCount];
+    }
+
+    private:
+    template <typename Rules>
+    void computeMoves(const Rules& rules, std::size_t first, std::size_t last){
+        std::size_t game = first;
+        if (useSimd){
+#if defined(__AVX2__)
+            const __m256i zero = _mm256_setzero_si256(), one = _mm256_set1_epi32(1), lowBits = _mm256_set1_epi32(31);
+            const __m256i boardWidth = _mm256_set1_epi32(width), boardHeight = _mm256_set1_epi32(height);
+            const __m256i lastX = _mm256_set1_epi32(width - 1), lastY = _mm256_set1_epi32(height - 1);
+            const __m256i isWrapped = _mm256_set1_epi32(rules.wraps ? -1 : 0), words = _mm256_set1_epi32(wordCount);
+            const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            for (; game + 8 <= last; game += 8){
+                __m256i x = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&headX[game])), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&dirX[game])));
+                __m256i y = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&headY[game])), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&dirY[game])));
+                __m256i lowX = _mm256_cmpgt_epi32(zero, x), highX = _mm256_cmpgt_epi32(x, lastX);
+                __m256i lowY = _mm256_cmpgt_epi32(zero, y), highY = _mm256_cmpgt_epi32(y, lastY);
+                __m256i outside = _mm256_or_si256(_mm256_or_si256(lowX, highX), _mm256_or_si256(lowY, highY));
+                x = _mm256_sub_epi32(_mm256_add_epi32(x, _mm256_and_si256(lowX, boardWidth)), _mm256_and_si256(highX, boardWidth));
+                y = _mm256_sub_epi32(_mm256_add_epi32(y, _mm256_and_si256(lowY, boardHeight)), _mm256_and_si256(highY, boardHeight));
+                __m256i cell = _mm256_add_epi32(_mm256_mullo_epi32(y, boardWidth), x);
+                __m256i wall = _mm256_andnot_si256(isWrapped, outside);
+                __m256i food = _mm256_cmpeq_epi32(cell, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&foodCell[game])));
+                __m256i flags = _mm256_or_si256(_mm256_and_si256(wall, _mm256_set1_epi32(HitWall)), _mm256_and_si256(food, _mm256_set1_epi32(HitFood)));
+                if (rules.hasHoles){
+                    __m256i word = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(game)), laneIndex), words), _mm256_srli_epi32(cell, 5));
+                    __m256i bits = _mm256_i32gather_epi32(reinterpret_cast<const int*>(blocked.data()), word, 4);
+                    __m256i isHole = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_srlv_epi32(bits, _mm256_and_si256(cell, lowBits)), one), one);
+                    flags = _mm256_or_si256(flags, _mm256_and_si256(isHole, _mm256_set1_epi32(HitBlock)));
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&nextX[game]), x);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&nextY[game]), y);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&nextCell[game]), cell);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&hazard[game]), flags);
+            }
+#elif defined(__SSE4_1__)
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i boardWidth = _mm_set1_epi32(width), boardHeight = _mm_set1_epi32(height);
+            const __m128i lastX = _mm_set1_epi32(width - 1), lastY = _mm_set1_epi32(height - 1);
+            const __m128i isWrapped = _mm_set1_epi32(rules.wraps ? -1 : 0);
+            for (; game + 4 <= last; game += 4){
+                __m128i x = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&headX[game])), _mm_loadu_si128(reinterpret_cast<const __m128i*>(&dirX[game])));
+                __m128i y = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&headY[game])), _mm_loadu_si128(reinterpret_cast<const __m128i*>(&dirY[game])));
+                __m128i lowX = _mm_cmplt_epi32(x, zero), highX = _mm_cmpgt_epi32(x, lastX);
+                __m128i lowY = _mm_cmplt_epi32(y, zero), highY = _mm_cmpgt_epi32(y, lastY);
+                __m128i outside = _mm_or_si128(_mm_or_si128(lowX, highX), _mm_or_si128(lowY, highY));
+                x = _mm_sub_epi32(_mm_add_epi32(x, _mm_and_si128(lowX, boardWidth)), _mm_and_si128(highX, boardWidth));
+                y = _mm_sub_epi32(_mm_add_epi32(y, _mm_and_si128(lowY, boardHeight)), _mm_and_si128(highY, boardHeight));
+                __m128i cell = _mm_add_epi32(_mm_mullo_epi32(y, boardWidth), x);
+                __m128i wall = _mm_andnot_si128(isWrapped, outside);
+                __m128i food = _mm_cmpeq_epi32(cell, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&foodCell[game])));
+                __m128i flags = _mm_or_si128(_mm_and_si128(wall, _mm_set1_epi32(HitWall)), _mm_and_si128(food, _mm_set1_epi32(HitFood)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&nextX[game]), x);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&nextY[game]), y);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&nextCell[game]), cell);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&hazard[game]), flags);
+            }
+            if (rules.hasHoles){
+                for (std::size_t i = first; i < game; i++){
+                    if (!(hazard[i] & HitWall) && isBlocked(i, nextCell[i])) hazard[i] |= HitBlock;
+                }
+            }
+#endif
+        }
+        for (; game < last; game++){
+            std::int32_t x = headX[game] + dirX[game], y = headY[game] + dirY[game], flags = 0;
+            bool isOutside = x < 0 || y < 0 || x >= width || y >= height;
+            x = x < 0 ? x + width : x >= width ? x - width : x;
+            y = y < 0 ? y + height : y >= height ? y - height : y;
+            std::int32_t cell = y * width + x;
+            if (isOutside && !rules.wraps) flags |= HitWall;
+            else if (rules.hasHoles && isBlocked(game, cell)) flags |= HitBlock;
+            if (cell == foodCell[game]) flags |= HitFood;
+            nextX[game] = x, nextY[game] = y, nextCell[game] = cell, hazard[game] = flags;
+        }
+    }
+
+    template <typename Rules>
+    void commit(const Rules& rules, std::size_t game){
+        std::int32_t flags = hazard[game];
+        std::uint32_t next = static_cast<std::uint32_t>(nextCell[game]);
+        if (flags & (HitWall | HitBlock)){
+            status[game] = Lost;
+            return;
+        }
+        bool isTailPopped = !isGrowing[game];
+        std::uint32_t tail = isTailPopped ? popBack(game) : 0;
+        isGrowing[game] = 0;
+        if (isOccupied(game, next)){
+            if (isNextLevel[game]) pushFront(game, next);
+            else if (isTailPopped) pushBack(game, tail);
+            status[game] = Lost;
+            return;
+        }
+        pushFront(game, next);
+        headX[game] = nextX[game], headY[game] = nextY[game];
+        if (flags & HitFood) eat(rules, game);
+    }
+
+    template <typename Rules>
+    void eat(const Rules& rules, std::size_t game){
+        int points = 1;
+        if (rules.hasBonusFood && ++foodInt[game] > rules.bonusFoodEvery){
+            foodInt[game] = 0;
+            points = rules.bonusPoints;
+            for (int i = 0; i < rules.bonusGrowth; i++) pushBack(game, bodyAt(game, bodyCount[game] - 1));
+        }
+        gameScore[game] += points, reward[game] = points;
+        if (rules.hasLevels && gameScore[game] % cellCount == 0) nextLevel(game);
+        else isGrowing[game] = 1, isNextLevel[game] = 0;
+        spawnFood(game);
+        if (rules.isWon(gameScore[game], cellCount)) status[game] = Won;
+    }
+
+    void nextLevel(std::size_t game){
+        isNextLevel[game] = 1;
+        std::uint32_t head = bodyAt(game, 0);
+        while (bodyCount[game] > 0) popBack(game);
+        bodyHead[game] = 0;
+        pushBack(game, head);
+    }
+
+    void spawnFood(std::size_t game){
+        if (freeCount[game] == 0){
+            status[game] = Won;
+            return;
+        }
+        std::uniform_int_distribution<std::size_t> dist(0, freeCount[game] - 1);
+        foodCell[game] = freeCells[game * cellCount + dist(foodRng[game])];
+    }
+
+    void spawnHoles(std::size_t game, std::uint32_t seed){
+        Rng genHoles;
+        genHoles.seed(seed + 1);
+        std::array<sf::Vector2i, 2> holes;
+        int placed = holePlacer.sample(genHoles, std::span(holes));
+        for (int hole = 0; hole < placed; hole++){
+            for (int y = 0; y < holeSize; y++){
+                for (int x = 0; x < holeSize; x++) block(game, (holes[hole].y + y) * width + holes[hole].x + x);
+            }
+        }
+    }
+
+    void block(std::size_t game, std::uint32_t cell){
+        std::uint32_t& word = blocked[game * wordCount + (cell >> 5)];
+        if (word >> (cell & 31) & 1) return;
+        word |= 1u << (cell & 31);
+        if (!isOccupied(game, cell)) removeFree(game, cell);
+    }
+
+    void occupy(std::size_t game, std::uint32_t cell){
+        std::uint32_t& word = occupied[game * wordCount + (cell >> 5)];
+        if (word >> (cell & 31) & 1) return;
+        word |= 1u << (cell & 31);
+        if (!isBlocked(game, cell)) removeFree(game, cell);
+    }
+
+    void pushFront(std::size_t game, std::uint32_t cell){
+        if (bodyCount[game] == static_cast<std::uint32_t>(cellCount)) return;
+        bodyHead[game] = bodyHead[game] == 0 ? cellCount - 1 : bodyHead[game] - 1;
+        body[game * cellCount + bodyHead[game]] = static_cast<std::uint16_t>(cell);
+        bodyCount[game]++;
+        occupy(game, cell);
+    }
+
+    void pushBack(std::size_t game, std::uint32_t cell){
+        if (bodyCount[game] == static_cast<std::uint32_t>(cellCount)) return;
+        body[game * cellCount + (bodyHead[game] + bodyCount[game]) % cellCount] = static_cast<std::uint16_t>(cell);
+        bodyCount[game]++;
+        occupy(game, cell);
+    }
+
+    std::uint32_t popBack(std::size_t game){
+        std::uint32_t cell = bodyAt(game, --bodyCount[game]);
+        if (bodyCount[game] > 0 && bodyAt(game, bodyCount[game] - 1) == cell) return cell;
+        occupied[game * wordCount + (cell >> 5)] &= ~(1u << (cell & 31));
+        if (!isBlocked(game, cell)) addFree(game, cell);
+        return cell;
+    }
+
+    void removeFree(std::size_t game, std::uint32_t cell){
+        std::uint16_t* cells = freeCells.data() + game * cellCount;
+        std::uint16_t* index = freeIndex.data() + game * cellCount;
+        std::uint16_t position = index[cell], last = cells[--freeCount[game]];
+        cells[position] = last, index[last] = position;
+        cells[freeCount[game]] = static_cast<std::uint16_t>(cell), index[cell] = static_cast<std::uint16_t>(freeCount[game]);
+    }
+
+    void addFree(std::size_t game, std::uint32_t cell){
+        std::uint16_t* cells = freeCells.data() + game * cellCount;
+        std::uint16_t* index = freeIndex.data() + game * cellCount;
+        std::uint16_t position = index[cell], first = cells[freeCount[game]];
+        cells[position] = first, index[first] = position;
+        cells[freeCount[game]] = static_cast<std::uint16_t>(cell), index[cell] = static_cast<std::uint16_t>(freeCount[game]++);
+    }
+};
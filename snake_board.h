@@ -0,0 +1,168 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+#include <array>
+#include <span>
+#include <random>
+#include <cstdint>
+#include <algorithm>
+
+class BoardGrid {
+    public:
+    static constexpr int minWidth = 42, minHeight = 19, maxWidth = 1000, maxHeight = 1000;
+    static constexpr int maxSnakes = 4;
+    enum CellFlag : std::uint8_t { Obstacle = 1, NoFood = 2 };
+    int width, height;
+
+    BoardGrid() : width{0}, height{0} {}
+
+    void resize(int newWidth, int newHeight){
+        width = std::clamp(newWidth, minWidth, maxWidth);
+        height = std::clamp(newHeight, minHeight, maxHeight);
+        std::size_t cellCount = static_cast<std::size_t>(width) * height;
+        occupancy.assign(cellCount, 0);
+        owner.assign(cellCount, 0);
+        cellFlags.assign(cellCount, 0);
+        freeCells.resize(cellCount);
+        freeIndex.resize(cellCount);
+        reset();
+    }
+
+    void reset(){
+        std::fill(occupancy.begin(), occupancy.end(), 0);
+        std::fill(cellFlags.begin(), cellFlags.end(), 0);
+        for (std::uint32_t cell = 0; cell < freeCells.size(); cell++){
+            freeCells[cell] = cell;
+            freeIndex[cell] = cell;
+        }
+        freeCount = freeCells.size(), obstacleCount = 0;
+    }
+
+    void loadLayout(std::span<const std::uint8_t> flags, std::span<const std::uint32_t> cells, std::span<const std::uint32_t> index, std::size_t newFreeCount, std::size_t newObstacleCount){
+        std::fill(occupancy.begin(), occupancy.end(), 0);
+        std::copy(flags.begin(), flags.end(), cellFlags.begin());
+        std::copy(cells.begin(), cells.end(), freeCells.begin());
+        std::copy(index.begin(), index.end(), freeIndex.begin());
+        freeCount = newFreeCount, obstacleCount = newObstacleCount;
+    }
+
+    std::size_t cellCount() const { return occupancy.size(); }
+    std::size_t openCellCount() const { return occupancy.size() - obstacleCount; }
+    std::uint32_t toCell(sf::Vector2i pos) const { return static_cast<std::uint32_t>(pos.y) * width + pos.x; }
+    sf::Vector2i toPos(std::uint32_t cell) const { return sf::Vector2i(cell % width, cell / width); }
+    bool isInside(sf::Vector2i pos) const { return pos.x >= 0 && pos.y >= 0 && pos.x < width && pos.y < height; }
+    bool isOccupied(sf::Vector2i pos) const { return occupancy[toCell(pos)] != 0; }
+    int occupancyAt(sf::Vector2i pos) const { return occupancy[toCell(pos)]; }
+    std::uint8_t ownerAt(sf::Vector2i pos) const { return owner[toCell(pos)]; }
+    bool isBlocked(sf::Vector2i pos) const { return cellFlags[toCell(pos)] & Obstacle; }
+    std::size_t freeCellCount() const { return freeCount; }
+
+    void occupy(std::uint32_t cell, std::uint8_t ownerId = 0){
+        owner[cell] = ownerId;
+        if (occupancy[cell]++ == 0 && !cellFlags[cell]) removeFree(cell);
+    }
+
+    void release(std::uint32_t cell){
+        if (--occupancy[cell] == 0 && !cellFlags[cell]) addFree(cell);
+    }
+
+    void block(sf::Vector2i pos){
+        std::uint32_t cell = toCell(pos);
+        if (cellFlags[cell] & Obstacle) return;
+        if (occupancy[cell] == 0 && !cellFlags[cell]) removeFree(cell);
+        cellFlags[cell] |= Obstacle;
+        obstacleCount++;
+    }
+
+    template <typename Rng>
+    bool randomFreeCell(Rng& rng, sf::Vector2i& out) const {
+        if (freeCount == 0) return false;
+        std::uniform_int_distribution<std::size_t> dist(0, freeCount - 1);
+        out = toPos(freeCells[dist(rng)]);
+        return true;
+    }
+
+    private:
+    std::vector<std::uint16_t> occupancy;
+    std::vector<std::uint8_t> owner, cellFlags;
+    std::vector<std::uint32_t> freeCells, freeIndex;
+    std::size_t freeCount = 0, obstacleCount = 0;
+
+    void removeFree(std::uint32_t cell){
+        std::uint32_t index = freeIndex[cell], last = freeCells[--freeCount];
+        freeCells[index] = last;
+        freeIndex[last] = index;
+        freeCells[freeCount] = cell;
+        freeIndex[cell] = static_cast<std::uint32_t>(freeCount);
+    }
+
+    void addFree(std::uint32_t cell){
+        std::uint32_t index = freeIndex[cell], first = freeCells[freeCount];
+        freeCells[index] = first;
+        freeIndex[first] = index;
+        freeCells[freeCount] = cell;
+        freeIndex[cell] = static_cast<std::uint32_t>(freeCount++);
+    }
+};
+
+class SnakeBody {
+    public:
+    BoardGrid& grid;
+    std::uint8_t id;
+
+    SnakeBody(BoardGrid& grid, std::uint8_t id = 0) : grid{grid}, id{id} {}
+
+    void resize(){
+        cells.assign(grid.cellCount(), 0);
+        head = 0, count = 0;
+    }
+
+    bool pushFront(sf::Vector2i pos){
+        if (count == cells.size()) return false;
+        head = (head + cells.size() - 1) % cells.size();
+        cells[head] = grid.toCell(pos);
+        grid.occupy(cells[head], id);
+        count++;
+        return true;
+    }
+
+    bool pushBack(sf::Vector2i pos){
+        if (count == cells.size()) return false;
+        std::uint32_t& cell = cells[(head + count) % cells.size()];
+        cell = grid.toCell(pos);
+        grid.occupy(cell, id);
+        count++;
+        return true;
+    }
+
+    void popBack(){
+        if (count == 0) return;
+        grid.release(cells[(head + count - 1) % cells.size()]);
+        count--;
+    }
+
+    void clear(){
+        while (count > 0) popBack();
+        head = 0;
+    }
+
+    void assignFrom(const SnakeBody& other){
+        cells = other.cells;
+        head = other.head, count = other.count;
+    }
+
+    sf::Vector2i front() const { return grid.toPos(cells[head]); }
+    sf::Vector2i back() const { return grid.toPos(cells[(head + count - 1) % cells.size()]); }
+    sf::Vector2i at(std::size_t index) const { return grid.toPos(cells[(head + index) % cells.size()]); }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    std::array<std::span<const std::uint32_t>, 2> spans() const {
+        std::size_t firstCount = std::min(count, cells.size() - head);
+        return {std::span<const std::uint32_t>(cells.data() + head, firstCount), std::span<const std::uint32_t>(cells.data(), count - firstCount)};
+    }
+
+    private:
+    std::vector<std::uint32_t> cells;
+    std::size_t head = 0, count = 0;
+};
@@ -0,0 +1,204 @@
+#include "snake_env.h"
+#include "snake_batch.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#include <bit>
+
+struct SnakeEnv {
+    static constexpr std::size_t sliceAlignment = 16;
+    SnakeEnvConfig config;
+    SnakeBatch<> batch;
+    std::vector<std::uint32_t> seeds, ticks;
+    std::vector<std::size_t> sliceBegin;
+    const std::uint8_t* actions;
+    std::uint8_t* observations;
+    float* rewards;
+    std::uint8_t* status;
+    std::int32_t* scores;
+    void (SnakeEnv::*task)(std::size_t, std::size_t);
+
+    SnakeEnv(const SnakeEnvConfig& newConfig) : config{newConfig}, batch(newConfig.envCount, newConfig.width, newConfig.height, static_cast<SnakeBatch<>::Mode>(newConfig.mode)),
+        actions{nullptr}, observations{nullptr}, rewards{nullptr}, status{nullptr}, scores{nullptr}, task{nullptr}, generation{0}, pending{0}, isStopping{false} {
+        std::size_t envCount = batch.gameCount;
+        seeds.resize(envCount), ticks.assign(envCount, 0);
+        for (std::size_t i = 0; i < envCount; i++) seeds[i] = config.seed + static_cast<std::uint32_t>(i);
+        std::size_t threadCount = config.threadCount > 0 ? config.threadCount : std::max(1u, std::thread::hardware_concurrency());
+        threadCount = std::clamp<std::size_t>(threadCount, 1, (envCount + sliceAlignment - 1) / sliceAlignment);
+        std::size_t sliceSize = (envCount / threadCount + sliceAlignment - 1) / sliceAlignment * sliceAlignment;
+        for (std::size_t i = 0; i < threadCount; i++) sliceBegin.push_back(std::min(envCount, i * sliceSize));
+        sliceBegin.push_back(envCount);
+        for (std::size_t i = 1; i < threadCount; i++) workers.emplace_back(&SnakeEnv::workerLoop, this, i);
+        run(&SnakeEnv::resetSlice);
+    }
+
+    ~SnakeEnv(){
+        {
+            std::lock_guard lock(mutex);
+            isStopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    void run(void (SnakeEnv::*newTask)(std::size_t, std::size_t)){
+        task = newTask;
+        if (workers.empty()){
+            (this->*task)(sliceBegin[0], sliceBegin[1]);
+            return;
+        }
+        {
+            std::lock_guard lock(mutex);
+            generation++;
+            pending = workers.size();
+        }
+        wake.notify_all();
+        (this->*task)(sliceBegin[0], sliceBegin[1]);
+        std::unique_lock lock(mutex);
+        finished.wait(lock, [&]{ return pending == 0; });
+    }
+
+    void resetSlice(std::size_t first, std::size_t last){
+        for (std::size_t i = first; i < last; i++){
+            batch.reset(i, seeds[i]);
+            ticks[i] = 0;
+            if (observations) writeObservation(i, observations + i * batch.cellCount);
+        }
+    }
+
+    void stepSlice(std::size_t first, std::size_t last){
+        if (actions){
+            for (std::size_t i = first; i < last; i++){
+                if (actions[i] != SNAKE_ENV_NOOP) batch.turn(i, actions[i]);
+            }
+        }
+        batch.step(first, last);
+        for (std::size_t i = first; i < last; i++){
+            std::uint8_t result = batch.status[i];
+            ticks[i]++;
+            if (result == SNAKE_ENV_RUNNING && config.maxTicks != 0 && ticks[i] >= config.maxTicks) result = SNAKE_ENV_TRUNCATED;
+            if (rewards) rewards[i] = static_cast<float>(batch.reward[i]);
+            if (scores) scores[i] = batch.gameScore[i];
+            if (status) status[i] = result;
+            if (result != SNAKE_ENV_RUNNING && config.autoReset){
+                seeds[i] += static_cast<std::uint32_t>(batch.gameCount);
+                batch.reset(i, seeds[i]);
+                ticks[i] = 0;
+            }
+            if (observations) writeObservation(i, observations + i * batch.cellCount);
+        }
+    }
+
+    void writeObservation(std::size_t index, std::uint8_t* out) const {
+        std::memset(out, SNAKE_ENV_EMPTY, batch.cellCount);
+        const std::uint32_t* holes = batch.blocked.data() + index * batch.wordCount;
+        const std::uint32_t* bodies = batch.occupied.data() + index * batch.wordCount;
+        for (int word = 0; word < batch.wordCount; word++){
+            for (std::uint32_t bits = holes[word]; bits != 0; bits &= bits - 1) out[word * 32 + std::countr_zero(bits)] = SNAKE_ENV_HOLE;
+            for (std::uint32_t bits = bodies[word]; bits != 0; bits &= bits - 1) out[word * 32 + std::countr_zero(bits)] = SNAKE_ENV_BODY;
+        }
+        out[batch.foodCell[index]] = SNAKE_ENV_FOOD;
+        if (batch.bodyCount[index] > 0) out[batch.bodyAt(index, 0)] = SNAKE_ENV_HEAD;
+    }
+
+    private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    std::uint64_t generation;
+    std::size_t pending;
+    bool isStopping;
+
+    void workerLoop(std::size_t slice){
+        std::uint64_t seen = 0;
+        while (true){
+            {
+                std::unique_lock lock(mutex);
+                wake.wait(lock, [&]{ return isStopping || generation != seen; });
+                if (isStopping) return;
+                seen = generation;
+            }
+            (this->*task)(sliceBegin[slice], sliceBegin[slice + 1]);
+            std::lock_guard lock(mutex);
+            if (--pending == 0) finished.notify_one();
+        }
+    }
+};
+
+extern "C" {
+
+uint32_t snake_env_abi_version(void){
+    return SNAKE_ENV_ABI_VERSION;
+}
+
+void snake_env_default_config(SnakeEnvConfig* config){
+    if (!config) return;
+    *config = SnakeEnvConfig{};
+    config->structSize = sizeof(SnakeEnvConfig);
+    config->mode = SNAKE_ENV_CLS;
+    config->width = BoardGrid::minWidth, config->height = BoardGrid::minHeight;
+    config->envCount = 1, config->threadCount = 0;
+    config->seed = 0, config->maxTicks = 0;
+    config->autoReset = 1;
+}
+
+SnakeEnv* snake_env_create(const SnakeEnvConfig* config){
+    if (!config || config->structSize != sizeof(SnakeEnvConfig)){
+        std::cerr << "snake_env_create: config is missing or was built against a different ABI version\n";
+        return nullptr;
+    }
+    if (config->mode < SNAKE_ENV_CLS || config->mode > SNAKE_ENV_ARC || config->envCount < 1){
+        std::cerr << "snake_env_create: invalid mode " << config->mode << " or env count " << config->envCount << "\n";
+        return nullptr;
+    }
+    int width = std::clamp(config->width, BoardGrid::minWidth, BoardGrid::maxWidth), height = std::clamp(config->height, BoardGrid::minHeight, BoardGrid::maxHeight);
+    if (width * height > SnakeBatch<>::maxCells){
+        std::cerr << "snake_env_create: a " << width << "x" << height << " board exceeds the " << SnakeBatch<>::maxCells << " cell limit\n";
+        return nullptr;
+    }
+    try {
+        return new SnakeEnv(*config);
+    } catch (const std::exception& e){
+        std::cerr << "snake_env_create: " << e.what() << "\n";
+        return nullptr;
+    }
+}
+
+void snake_env_destroy(SnakeEnv* env){
+    delete env;
+}
+
+int snake_env_shape(const SnakeEnv* env, int32_t* envCount, int32_t* height, int32_t* width){
+    if (!env) return SNAKE_ENV_INVALID_ARGUMENT;
+    if (envCount) *envCount = static_cast<int32_t>(env->batch.gameCount);
+    if (height) *height = env->batch.height;
+    if (width) *width = env->batch.width;
+    return SNAKE_ENV_OK;
+}
+
+int snake_env_reset(SnakeEnv* env, const uint32_t* seeds, uint8_t* observations){
+    if (!env) return SNAKE_ENV_INVALID_ARGUMENT;
+    if (seeds) std::copy(seeds, seeds + env->batch.gameCount, env->seeds.begin());
+    env->observations = observations;
+    env->run(&SnakeEnv::resetSlice);
+    return SNAKE_ENV_OK;
+}
+
+int snake_env_reset_one(SnakeEnv* env, int32_t index, uint32_t seed, uint8_t* observation){
+    if (!env || index < 0 || static_cast<std::size_t>(index) >= env->batch.gameCount) return SNAKE_ENV_INVALID_ARGUMENT;
+    env->seeds[index] = seed;
+    env->batch.reset(index, seed);
+    env->ticks[index] = 0;
+    if (observation) env->writeObservation(index, observation);
+    return SNAKE_ENV_OK;
+}
+
+int snake_env_step(SnakeEnv* env, const uint8_t* actions, uint8_t* observations, float* rewards, uint8_t* status, int32_t* scores){
+    if (!env) return SNAKE_ENV_INVALID_ARGUMENT;
+    env->actions = actions, env->observations = observations, env->rewards = rewards, env->status = status, env->scores = scores;
+    env->run(&SnakeEnv::stepSlice);
+    return SNAKE_ENV_OK;
+}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(_WIN32)
+#if defined(SNAKE_ENV_BUILD)
+#define SNAKE_ENV_API __declspec(dllexport)
+#else
+#define SNAKE_ENV_API __declspec(dllimport)
+#endif
+#else
+#define SNAKE_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SNAKE_ENV_ABI_VERSION 1
+
+typedef struct SnakeEnv SnakeEnv;
+
+enum { SNAKE_ENV_CLS = 0, SNAKE_ENV_INF = 1, SNAKE_ENV_ARC = 2 };
+enum { SNAKE_ENV_UP = 0, SNAKE_ENV_DOWN = 1, SNAKE_ENV_LEFT = 2, SNAKE_ENV_RIGHT = 3, SNAKE_ENV_NOOP = 255 };
+enum { SNAKE_ENV_EMPTY = 0, SNAKE_ENV_BODY = 1, SNAKE_ENV_HEAD = 2, SNAKE_ENV_FOOD = 3, SNAKE_ENV_HOLE = 4 };
+enum { SNAKE_ENV_RUNNING = 0, SNAKE_ENV_LOST = 1, SNAKE_ENV_WON = 2, SNAKE_ENV_TRUNCATED = 3 };
+enum { SNAKE_ENV_OK = 0, SNAKE_ENV_INVALID_ARGUMENT = -1, SNAKE_ENV_VERSION_MISMATCH = -2 };
+
+typedef struct SnakeEnvConfig {
+    uint32_t structSize;
+    int32_t mode;
+    int32_t width, height;
+    int32_t envCount;
+    int32_t threadCount;
+    uint32_t seed;
+    uint32_t maxTicks;
+    int32_t autoReset;
+} SnakeEnvConfig;
+
+SNAKE_ENV_API uint32_t snake_env_abi_version(void);
+SNAKE_ENV_API void snake_env_default_config(SnakeEnvConfig* config);
+SNAKE_ENV_API SnakeEnv* snake_env_create(const SnakeEnvConfig* config);
+SNAKE_ENV_API void snake_env_destroy(SnakeEnv* env);
+SNAKE_ENV_API int snake_env_shape(const SnakeEnv* env, int32_t* envCount, int32_t* height, int32_t* width);
+SNAKE_ENV_API int snake_env_reset(SnakeEnv* env, const uint32_t* seeds, uint8_t* observations);
+SNAKE_ENV_API int snake_env_reset_one(SnakeEnv* env, int32_t index, uint32_t seed, uint8_t* observation);
+SNAKE_ENV_API int snake_env_step(SnakeEnv* env, const uint8_t* actions, uint8_t* observations, float* rewards, uint8_t* status, int32_t* scores);
+
+#ifdef __cplusplus
+}
+#endif
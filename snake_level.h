@@ -0,0 +1,245 @@
+#pragma once
+#include "snake_board.h"
+#include "mapped_file.h"
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <bit>
+#include <iostream>
+
+static_assert(std::endian::native == std::endian::little, "Level files are stored little-endian");
+
+struct LevelSpawn {
+    std::uint16_t x, y;
+    std::uint8_t direction, reserved[3];
+};
+
+struct LevelZone {
+    std::uint16_t x, y, width, height;
+};
+
+struct LevelHeader {
+    std::uint32_t magic, version;
+    std::uint64_t contentHash;
+    std::uint32_t totalSize;
+    std::uint16_t width, height;
+    std::uint8_t wrapRule, spawnCount, zoneCount, nameSize;
+    std::uint32_t obstacleCount, freeCount;
+    std::uint32_t freeCellsOffset, freeIndexOffset, spawnOffset, zoneOffset, flagsOffset, nameOffset, reserved;
+};
+
+static_assert(sizeof(LevelHeader) == 64 && sizeof(LevelSpawn) == 8 && sizeof(LevelZone) == 8);
+
+struct LevelFormat {
+    enum WrapRule : std::uint8_t { ModeWraps, AlwaysWraps, NeverWraps };
+    static constexpr std::uint32_t levelMagic = 0x4C4B4E53, packMagic = 0x504B4E53, version = 1;
+    static constexpr int maxNameSize = 255;
+
+    static std::uint32_t align(std::size_t offset){
+        return static_cast<std::uint32_t>((offset + 7) & ~std::size_t(7));
+    }
+};
+
+class LevelView {
+    public:
+    const LevelHeader* header = nullptr;
+
+    static bool parse(const std::uint8_t* data, std::size_t size, LevelView& out){
+        if (size < sizeof(LevelHeader) || reinterpret_cast<std::uintptr_t>(data) % alignof(LevelHeader) != 0) return false;
+        const LevelHeader& head = *reinterpret_cast<const LevelHeader*>(data);
+        if (head.magic != LevelFormat::levelMagic || head.version != LevelFormat::version || head.totalSize > size) return false;
+        if (head.width < BoardGrid::minWidth || head.width > BoardGrid::maxWidth || head.height < BoardGrid::minHeight || head.height > BoardGrid::maxHeight) return false;
+        if (head.spawnCount < 1 || head.spawnCount > BoardGrid::maxSnakes || head.wrapRule > LevelFormat::NeverWraps) return false;
+        std::size_t cellCount = static_cast<std::size_t>(head.width) * head.height;
+        auto fits = [&](std::uint32_t offset, std::size_t bytes){ return offset % 4 == 0 && offset >= sizeof(LevelHeader) && offset + bytes <= head.totalSize; };
+        if (!fits(head.freeCellsOffset, cellCount * 4) || !fits(head.freeIndexOffset, cellCount * 4) || !fits(head.spawnOffset, head.spawnCount * sizeof(LevelSpawn)) ||
+            !fits(head.zoneOffset, head.zoneCount * sizeof(LevelZone)) || !fits(head.flagsOffset, cellCount) || !fits(head.nameOffset, head.nameSize)) return false;
+        if (head.freeCount > cellCount || head.obstacleCount > cellCount || head.nameSize > LevelFormat::maxNameSize) return false;
+        LevelView view;
+        view.header = &head;
+        for (const LevelSpawn& spawn : view.spawns()){
+            if (spawn.x >= head.width || spawn.y >= head.height || spawn.direction > 3 || view.cellFlags()[spawn.y * head.width + spawn.x] & BoardGrid::Obstacle) return false;
+        }
+        out = view;
+        return true;
+    }
+
+    bool hasConsistentCells() const {
+        const std::uint8_t* flags = cellFlags().data();
+        const std::uint32_t* cells = freeCells().data();
+        const std::uint32_t* index = freeIndex().data();
+        std::size_t obstacles = 0;
+        for (std::uint32_t i = 0; i < cellCount(); i++){
+            std::uint32_t cell = cells[i];
+            if (cell >= cellCount() || index[cell] != i || (i < header->freeCount) != (flags[cell] == 0) || flags[cell] > (BoardGrid::Obstacle | BoardGrid::NoFood)) return false;
+            obstacles += flags[cell] & BoardGrid::Obstacle;
+        }
+        return obstacles == header->obstacleCount;
+    }
+
+    int width() const { return header->width; }
+    int height() const { return header->height; }
+    std::uint8_t wrapRule() const { return header->wrapRule; }
+    std::uint64_t contentHash() const { return header->contentHash; }
+    std::string_view name() const { return std::string_view(reinterpret_cast<const char*>(base() + header->nameOffset), header->nameSize); }
+    std::span<const LevelSpawn> spawns() const { return std::span(reinterpret_cast<const LevelSpawn*>(base() + header->spawnOffset), header->spawnCount); }
+    std::span<const LevelZone> zones() const { return std::span(reinterpret_cast<const LevelZone*>(base() + header->zoneOffset), header->zoneCount); }
+    std::span<const std::uint8_t> cellFlags() const { return std::span(base() + header->flagsOffset, cellCount()); }
+    std::span<const std::uint32_t> freeCells() const { return std::span(reinterpret_cast<const std::uint32_t*>(base() + header->freeCellsOffset), cellCount()); }
+    std::span<const std::uint32_t> freeIndex() const { return std::span(reinterpret_cast<const std::uint32_t*>(base() + header->freeIndexOffset), cellCount()); }
+
+    void applyTo(BoardGrid& board) const {
+        if (board.width != width() || board.height != height()) board.resize(width(), height());
+        board.loadLayout(cellFlags(), freeCells(), freeIndex(), header->freeCount, header->obstacleCount);
+    }
+
+    private:
+    const std::uint8_t* base() const { return reinterpret_cast<const std::uint8_t*>(header); }
+    std::size_t cellCount() const { return static_cast<std::size_t>(header->width) * header->height; }
+};
+
+struct LevelLayout {
+    std::string name;
+    int width = BoardGrid::minWidth, height = BoardGrid::minHeight;
+    std::uint8_t wrapRule = LevelFormat::ModeWraps;
+    std::vector<std::uint8_t> obstacles;
+    std::vector<LevelSpawn> spawns;
+    std::vector<LevelZone> zones;
+
+    std::vector<std::uint8_t> encode() const {
+        std::size_t cellCount = static_cast<std::size_t>(width) * height;
+        if (width < BoardGrid::minWidth || width > BoardGrid::maxWidth || height < BoardGrid::minHeight || height > BoardGrid::maxHeight || obstacles.size() != cellCount){
+            std::cerr << "Level \"" << name << "\" must be between " << BoardGrid::minWidth << "x" << BoardGrid::minHeight << " and " << BoardGrid::maxWidth << "x" << BoardGrid::maxHeight << "\n";
+            return {};
+        }
+        if (spawns.empty() || spawns.size() > BoardGrid::maxSnakes || zones.size() > 255 || name.size() > LevelFormat::maxNameSize){
+            std::cerr << "Level \"" << name << "\" needs 1 to " << BoardGrid::maxSnakes << " spawn points, at most 255 food zones and a name under 256 bytes\n";
+            return {};
+        }
+        std::vector<std::uint8_t> flags(cellCount, zones.empty() ? 0 : BoardGrid::NoFood);
+        for (const LevelZone& zone : zones){
+            for (int y = zone.y; y < std::min<int>(zone.y + zone.height, height); y++){
+                for (int x = zone.x; x < std::min<int>(zone.x + zone.width, width); x++) flags[y * width + x] = 0;
+            }
+        }
+        std::uint32_t obstacleCount = 0;
+        for (std::size_t cell = 0; cell < cellCount; cell++){
+            if (obstacles[cell]) flags[cell] |= BoardGrid::Obstacle, obstacleCount++;
+        }
+        for (const LevelSpawn& spawn : spawns){
+            if (spawn.x >= width || spawn.y >= height || flags[spawn.y * width + spawn.x] & BoardGrid::Obstacle){
+                std::cerr << "Level \"" << name << "\" has a spawn point outside the board or inside an obstacle\n";
+                return {};
+            }
+        }
+
+        LevelHeader head{};
+        head.magic = LevelFormat::levelMagic, head.version = LevelFormat::version;
+        head.width = static_cast<std::uint16_t>(width), head.height = static_cast<std::uint16_t>(height);
+        head.wrapRule = wrapRule, head.spawnCount = static_cast<std::uint8_t>(spawns.size()), head.zoneCount = static_cast<std::uint8_t>(zones.size());
+        head.nameSize = static_cast<std::uint8_t>(name.size()), head.obstacleCount = obstacleCount;
+        head.freeCellsOffset = LevelFormat::align(sizeof(LevelHeader));
+        head.freeIndexOffset = LevelFormat::align(head.freeCellsOffset + cellCount * 4);
+        head.spawnOffset = LevelFormat::align(head.freeIndexOffset + cellCount * 4);
+        head.zoneOffset = LevelFormat::align(head.spawnOffset + spawns.size() * sizeof(LevelSpawn));
+        head.flagsOffset = LevelFormat::align(head.zoneOffset + zones.size() * sizeof(LevelZone));
+        head.nameOffset = LevelFormat::align(head.flagsOffset + cellCount);
+        head.totalSize = LevelFormat::align(head.nameOffset + name.size());
+
+        std::vector<std::uint8_t> out(head.totalSize, 0);
+        std::uint32_t* cells = reinterpret_cast<std::uint32_t*>(out.data() + head.freeCellsOffset);
+        std::uint32_t* index = reinterpret_cast<std::uint32_t*>(out.data() + head.freeIndexOffset);
+        std::uint32_t next = 0;
+        for (int pass = 0; pass < 2; pass++){
+            for (std::uint32_t cell = 0; cell < cellCount; cell++){
+                if ((flags[cell] == 0) != (pass == 0)) continue;
+                cells[next] = cell, index[cell] = next++;
+                if (pass == 0) head.freeCount = next;
+            }
+        }
+        std::memcpy(out.data() + head.spawnOffset, spawns.data(), spawns.size() * sizeof(LevelSpawn));
+        std::memcpy(out.data() + head.zoneOffset, zones.data(), zones.size() * sizeof(LevelZone));
+        std::memcpy(out.data() + head.flagsOffset, flags.data(), cellCount);
+        std::memcpy(out.data() + head.nameOffset, name.data(), name.size());
+        head.contentHash = fnv1aHash(out.data() + sizeof(LevelHeader), out.size() - sizeof(LevelHeader));
+        std::memcpy(out.data(), &head, sizeof(LevelHeader));
+        return out;
+    }
+};
+
+struct LevelPackHeader {
+    std::uint32_t magic, version, levelCount, reserved;
+};
+
+struct LevelPackEntry {
+    std::uint64_t offset;
+    std::uint32_t size, reserved;
+};
+
+class LevelPack {
+    public:
+    bool open(const std::string& path){
+        levels.clear(), cellState.clear();
+        if (!file.open(path)){
+            std::cerr << "Failed to map level pack " << path << "\n";
+            return false;
+        }
+        if (!parse(file.data(), file.size())){
+            std::cerr << "Level pack " << path << " is corrupt or from a different version\n";
+            levels.clear();
+            file.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool parse(const std::uint8_t* data, std::size_t size){
+        if (size < sizeof(LevelPackHeader)) return false;
+        const LevelPackHeader& head = *reinterpret_cast<const LevelPackHeader*>(data);
+        if (head.magic != LevelFormat::packMagic || head.version != LevelFormat::version || head.levelCount > (size - sizeof(LevelPackHeader)) / sizeof(LevelPackEntry)) return false;
+        const LevelPackEntry* entries = reinterpret_cast<const LevelPackEntry*>(data + sizeof(LevelPackHeader));
+        levels.resize(head.levelCount), cellState.assign(head.levelCount, Unchecked);
+        for (std::uint32_t i = 0; i < head.levelCount; i++){
+            if (entries[i].offset > size || entries[i].size > size - entries[i].offset || !LevelView::parse(data + entries[i].offset, entries[i].size, levels[i])) return false;
+        }
+        return true;
+    }
+
+    static std::vector<std::uint8_t> build(const std::vector<std::vector<std::uint8_t>>& encodedLevels){
+        std::vector<std::uint8_t> out(LevelFormat::align(sizeof(LevelPackHeader) + encodedLevels.size() * sizeof(LevelPackEntry)), 0);
+        LevelPackHeader head{LevelFormat::packMagic, LevelFormat::version, static_cast<std::uint32_t>(encodedLevels.size()), 0};
+        std::memcpy(out.data(), &head, sizeof(head));
+        for (std::size_t i = 0; i < encodedLevels.size(); i++){
+            LevelPackEntry entry{out.size(), static_cast<std::uint32_t>(encodedLevels[i].size()), 0};
+            std::memcpy(out.data() + sizeof(LevelPackHeader) + i * sizeof(LevelPackEntry), &entry, sizeof(entry));
+            out.insert(out.end(), encodedLevels[i].begin(), encodedLevels[i].end());
+            out.resize(LevelFormat::align(out.size()), 0);
+        }
+        return out;
+    }
+
+    std::size_t size() const { return levels.size(); }
+    bool empty() const { return levels.empty(); }
+    const LevelView& operator[](std::size_t index) const { return levels[index]; }
+
+    const LevelView* load(std::size_t index){
+        if (index >= levels.size()) return nullptr;
+        if (cellState[index] == Unchecked) cellState[index] = levels[index].hasConsistentCells() ? Consistent : Corrupt;
+        if (cellState[index] == Consistent) return &levels[index];
+        std::cerr << "Level \"" << levels[index].name() << "\" has a corrupt cell table\n";
+        return nullptr;
+    }
+
+    const LevelView* find(std::uint64_t contentHash) const {
+        for (const LevelView& level : levels){
+            if (level.contentHash() == contentHash) return &level;
+        }
+        return nullptr;
+    }
+
+    private:
+    enum CellState : std::uint8_t { Unchecked, Consistent, Corrupt };
+    MappedFile file;
+    std::vector<LevelView> levels;
+    std::vector<std::uint8_t> cellState;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+struct ModeRules {
+    static constexpr int bonusFoodEvery = 5, bonusPoints = 5, bonusGrowth = 4, arcadeWinScore = 999;
+};
+
+struct ClassicMode : ModeRules {
+    static constexpr bool wraps = false, hasHoles = false, hasLevels = false, hasBonusFood = false;
+    static constexpr bool isWon(int score, int cellCount){ return score == cellCount; }
+};
+
+struct InfiniteMode : ModeRules {
+    static constexpr bool wraps = false, hasHoles = false, hasLevels = true, hasBonusFood = false;
+    static constexpr bool isWon(int, int){ return false; }
+};
+
+struct ArcadeMode : ModeRules {
+    static constexpr bool wraps = true, hasHoles = true, hasLevels = false, hasBonusFood = true;
+    static constexpr bool isWon(int score, int){ return score == arcadeWinScore; }
+};
+
+struct RuntimeMode : ModeRules {
+    bool wraps, hasHoles, hasLevels, hasBonusFood, winsOnFill, winsAtScoreLimit;
+
+    static RuntimeMode fromFlags(bool isClassic, bool isInfinite, bool isArcade){
+        return RuntimeMode{{}, isArcade, isArcade, isInfinite, isArcade, isClassic, isArcade};
+    }
+
+    bool isWon(int score, int cellCount) const {
+        return (winsOnFill && score == cellCount) || (winsAtScoreLimit && score == arcadeWinScore);
+    }
+};
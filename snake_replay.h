@@ -0,0 +1,170 @@
+#pragma once
+#include "snake_sim.h"
+#include "byte_stream.h"
+#include <string>
+#include <zlib.h>
+#include <openssl/evp.h>
+
+struct ReplayInput {
+    std::uint32_t tick;
+    std::uint8_t snakeIndex, code;
+};
+
+class ReplayLog {
+    public:
+    enum Mode : std::uint8_t { CLS, INF, ARC };
+    static constexpr std::uint8_t formatVersion = 2;
+    static constexpr std::uint32_t maxTicks = 10000000, maxRawSize = 4 * 1024 * 1024;
+    // 64K turns (512 KiB) reserved up front, far longer than a played game, so recording on the simulation thread never grows the vector.
+    static constexpr std::size_t reservedInputs = 1 << 16;
+    std::uint32_t seed, tickCount;
+    int boardWidth, boardHeight, snakeCount, holeCount, score;
+    std::uint8_t mode;
+    std::vector<ReplayInput> inputs;
+
+    ReplayLog() : seed{0}, tickCount{0}, boardWidth{BoardGrid::minWidth}, boardHeight{BoardGrid::minHeight}, snakeCount{1}, holeCount{SnakeSim::defaultHoles}, score{0}, mode{CLS} {}
+
+    // The shared leaderboard only ranks solo INF games on the default board, so every entry played the same game.
+    bool isRanked() const {
+        return mode == INF && boardWidth == BoardGrid::minWidth && boardHeight == BoardGrid::minHeight && snakeCount == 1 && holeCount == SnakeSim::defaultHoles;
+    }
+
+    void begin(const SnakeSim& sim, std::uint32_t newSeed){
+        seed = newSeed, tickCount = 0, score = 0;
+        boardWidth = sim.board.width, boardHeight = sim.board.height, snakeCount = static_cast<int>(sim.snakes.size()), holeCount = sim.holeCount;
+        mode = sim.isARCModeStarted ? ARC : sim.isINFModeStarted ? INF : CLS;
+        inputs.clear();
+        inputs.reserve(reservedInputs);
+    }
+
+    void recordTurn(int snakeIndex, sf::Vector2i direction){
+        inputs.push_back(ReplayInput{tickCount + 1, static_cast<std::uint8_t>(snakeIndex), SnakeSim::toCode(direction)});
+    }
+
+    void recordStep(){
+        tickCount++;
+    }
+
+    std::vector<std::uint8_t> compress() const {
+        ByteWriter raw;
+        raw.bytes.reserve(16 + inputs.size() * 2);
+        raw.u8(formatVersion);
+        raw.varint(seed), raw.varint(boardWidth), raw.varint(boardHeight), raw.varint(snakeCount), raw.u8(mode), raw.varint(holeCount);
+        raw.varint(score), raw.varint(tickCount), raw.varint(static_cast<std::uint32_t>(inputs.size()));
+        std::uint32_t previousTick = 0;
+        for (const ReplayInput& input : inputs){
+            raw.varint(input.tick - previousTick);
+            raw.u8(input.snakeIndex << 2 | input.code);
+            previousTick = input.tick;
+        }
+        ByteWriter out;
+        out.varint(static_cast<std::uint32_t>(raw.bytes.size()));
+        std::size_t headerSize = out.bytes.size();
+        uLongf packedSize = compressBound(raw.bytes.size());
+        out.bytes.resize(headerSize + packedSize);
+        if (compress2(out.bytes.data() + headerSize, &packedSize, raw.bytes.data(), raw.bytes.size(), Z_BEST_COMPRESSION) != Z_OK) return {};
+        out.bytes.resize(headerSize + packedSize);
+        return out.bytes;
+    }
+
+    bool decompress(const std::uint8_t* data, std::size_t size){
+        ByteReader header(data, size);
+        std::uint32_t rawSize = header.varint();
+        if (!header.isValid || rawSize == 0 || rawSize > maxRawSize) return false;
+        std::vector<std::uint8_t> raw(rawSize);
+        uLongf unpackedSize = rawSize;
+        if (uncompress(raw.data(), &unpackedSize, data + header.offset, size - header.offset) != Z_OK || unpackedSize != rawSize) return false;
+
+        ByteReader in(raw.data(), raw.size());
+        std::uint8_t version = in.u8();
+        if (version < 1 || version > formatVersion) return false;
+        seed = in.varint();
+        boardWidth = in.varint(), boardHeight = in.varint(), snakeCount = in.varint();
+        mode = in.u8();
+        holeCount = version >= 2 ? static_cast<int>(in.varint()) : 2;
+        score = in.varint(), tickCount = in.varint();
+        std::uint32_t inputCount = in.varint();
+        if (!in.isValid || inputCount > rawSize / 2) return false;
+        inputs.resize(inputCount);
+        std::uint32_t tick = 0;
+        for (ReplayInput& input : inputs){
+            tick += in.varint();
+            std::uint8_t packed = in.u8();
+            input = ReplayInput{tick, static_cast<std::uint8_t>(packed >> 2), static_cast<std::uint8_t>(packed & 3)};
+        }
+        return in.isValid && in.offset == in.size;
+    }
+
+    static std::string toBase64(const std::vector<std::uint8_t>& data){
+        std::string out(4 * ((data.size() + 2) / 3), '\0');
+        int length = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(out.data()), data.data(), static_cast<int>(data.size()));
+        out.resize(length);
+        return out;
+    }
+
+    static bool fromBase64(const std::string& text, std::vector<std::uint8_t>& out){
+        if (text.size() % 4 != 0) return false;
+        out.resize(3 * text.size() / 4);
+        int length = EVP_DecodeBlock(out.data(), reinterpret_cast<const unsigned char*>(text.data()), static_cast<int>(text.size()));
+        if (length < 0) return false;
+        std::size_t padding = text.empty() ? 0 : (text.end()[-1] == '=') + (text.size() > 1 && text.end()[-2] == '=');
+        out.resize(length - padding);
+        return true;
+    }
+};
+
+class ReplayVerifier {
+    public:
+    enum Result { Accepted, Malformed, ScoreMismatch, EndedEarly, NotFinished, Unranked };
+    SnakeSim sim;
+    std::uint64_t verifiedTicks;
+
+    ReplayVerifier() : sim{0}, verifiedTicks{0} {}
+
+    Result verify(const ReplayLog& replay){
+        if (replay.boardWidth < BoardGrid::minWidth || replay.boardWidth > BoardGrid::maxWidth || replay.boardHeight < BoardGrid::minHeight || replay.boardHeight > BoardGrid::maxHeight ||
+            replay.snakeCount < 1 || replay.snakeCount > BoardGrid::maxSnakes || replay.holeCount < 0 || replay.holeCount > SnakeSim::maxHoles || replay.mode > ReplayLog::ARC || replay.tickCount == 0 || replay.tickCount > ReplayLog::maxTicks) return Malformed;
+        std::uint32_t previousTick = 0;
+        std::array<std::uint32_t, BoardGrid::maxSnakes> lastTurn{};
+        for (const ReplayInput& input : replay.inputs){
+            if (input.tick == 0 || input.tick < previousTick || input.tick > replay.tickCount || input.snakeIndex >= replay.snakeCount || lastTurn[input.snakeIndex] == input.tick) return Malformed;
+            previousTick = lastTurn[input.snakeIndex] = input.tick;
+        }
+
+        sim.boardWidth = replay.boardWidth, sim.boardHeight = replay.boardHeight, sim.snakeCount = replay.snakeCount, sim.holeCount = replay.holeCount;
+        sim.isCLSModeStarted = replay.mode == ReplayLog::CLS, sim.isINFModeStarted = replay.mode == ReplayLog::INF, sim.isARCModeStarted = replay.mode == ReplayLog::ARC;
+        sim.reseed(replay.seed);
+        sim.restart();
+        std::size_t next = 0;
+        for (std::uint32_t tick = 1; tick <= replay.tickCount; tick++){
+            if (sim.youLose || sim.youWon) return EndedEarly;
+            for (; next < replay.inputs.size() && replay.inputs[next].tick == tick; next++){
+                sim.turn(replay.inputs[next].snakeIndex, SnakeSim::toDirection(replay.inputs[next].code));
+            }
+            sim.step();
+        }
+        verifiedTicks += replay.tickCount;
+        if (!sim.youLose && !sim.youWon) return NotFinished;
+        return sim.gameScore == replay.score ? Accepted : ScoreMismatch;
+    }
+
+    Result verify(const std::uint8_t* data, std::size_t size){
+        if (!replay.decompress(data, size)) return Malformed;
+        return verify(replay);
+    }
+
+    static const char* describe(Result result){
+        switch (result){
+            case Accepted: return "accepted";
+            case Malformed: return "malformed replay";
+            case ScoreMismatch: return "score does not match replay";
+            case EndedEarly: return "game ended before the last replay tick";
+            case NotFinished: return "game did not end on the last replay tick";
+            case Unranked: return "only solo INF games on the default board are ranked";
+        }
+        return "unknown";
+    }
+
+    private:
+    ReplayLog replay;
+};
@@ -0,0 +1,278 @@
+#pragma once
+#include "snake_board.h"
+#include "snake_modes.h"
+#include "snake_level.h"
+#include "hole_placement.h"
+#include "log.h"
+#include <cstdlib>
+#include <memory>
+
+struct Snake {
+    SnakeBody body;
+    sf::Vector2i direction{1, 0}, spawnPos, spawnDirection{1, 0}, nextPos, tailPos;
+    int score = 0;
+    std::uint32_t moveCount = 0, resetCount = 0;
+    bool isAlive = true, isGrowing = false, isTailPopped = false;
+
+    Snake(BoardGrid& board, std::uint8_t id) : body{board, id} {}
+};
+
+class SnakeSim {
+    public:
+    static constexpr int holeSize = 6, maxHoles = 16, defaultHoles = 2;
+    BoardGrid board;
+    std::vector<Snake> snakes;
+    std::array<sf::Vector2i, maxHoles> holes;
+    const LevelView* level = nullptr;
+    sf::Vector2i foodPos;
+    int boardWidth, boardHeight, snakeCount, holeCount, placedHoles, gameScore, snakeInt, backgroundInt, foodInt;
+    unsigned int levelCount;
+    bool isCLSModeStarted, isINFModeStarted, isARCModeStarted, isFoodEaten, isNextLevel, youWon, youLose, isHoleSpawned;
+    std::mt19937 genFood, genHoles;
+    std::shared_ptr<const HolePlacer> holePlacer;
+
+    SnakeSim(std::uint32_t seed = std::random_device{}()) : boardWidth{BoardGrid::minWidth}, boardHeight{BoardGrid::minHeight}, snakeCount{1}, holeCount{defaultHoles}, placedHoles{0}, gameScore{1}, snakeInt{0}, backgroundInt{5}, foodInt{0}, levelCount{0}, isCLSModeStarted{false}, isINFModeStarted{false}, isARCModeStarted{false}, isFoodEaten{false}, isNextLevel{false}, youWon{false}, youLose{false}, isHoleSpawned{false} {
+        reseed(seed);
+        resizeBoard();
+        for (Snake& snake : snakes) snake.body.pushBack(snake.spawnPos);
+        spawnFood();
+    }
+
+    SnakeSim(const SnakeSim& other) : boardWidth{other.boardWidth}, boardHeight{other.boardHeight}, snakeCount{other.snakeCount}, holeCount{other.holeCount} {
+        *this = other;
+    }
+
+    SnakeSim& operator=(const SnakeSim& other){
+        if (this == &other) return *this;
+        board = other.board;
+        if (snakes.size() != other.snakes.size()){
+            snakes.clear();
+            for (std::size_t i = 0; i < other.snakes.size(); i++) snakes.emplace_back(board, static_cast<std::uint8_t>(i));
+        }
+        for (std::size_t i = 0; i < snakes.size(); i++){
+            Snake& snake = snakes[i];
+            const Snake& source = other.snakes[i];
+            snake.body.assignFrom(source.body);
+            snake.direction = source.direction, snake.spawnPos = source.spawnPos, snake.spawnDirection = source.spawnDirection, snake.nextPos = source.nextPos, snake.tailPos = source.tailPos;
+            snake.score = source.score, snake.moveCount = source.moveCount, snake.resetCount = source.resetCount;
+            snake.isAlive = source.isAlive, snake.isGrowing = source.isGrowing, snake.isTailPopped = source.isTailPopped;
+        }
+        foodPos = other.foodPos, holes = other.holes, level = other.level;
+        boardWidth = other.boardWidth, boardHeight = other.boardHeight, snakeCount = other.snakeCount, holeCount = other.holeCount, placedHoles = other.placedHoles;
+        gameScore = other.gameScore, snakeInt = other.snakeInt, backgroundInt = other.backgroundInt, foodInt = other.foodInt;
+        levelCount = other.levelCount;
+        isCLSModeStarted = other.isCLSModeStarted, isINFModeStarted = other.isINFModeStarted, isARCModeStarted = other.isARCModeStarted;
+        isFoodEaten = other.isFoodEaten, isNextLevel = other.isNextLevel, youWon = other.youWon, youLose = other.youLose, isHoleSpawned = other.isHoleSpawned;
+        genFood = other.genFood, genHoles = other.genHoles;
+        holePlacer = other.holePlacer;
+        return *this;
+    }
+
+    static sf::Vector2i toDirection(std::uint8_t code){
+        if (code == 0) return sf::Vector2i(0, -1);
+        if (code == 1) return sf::Vector2i(0, 1);
+        if (code == 2) return sf::Vector2i(-1, 0);
+        return sf::Vector2i(1, 0);
+    }
+
+    static std::uint8_t toCode(sf::Vector2i direction){
+        if (direction.y < 0) return 0;
+        if (direction.y > 0) return 1;
+        if (direction.x < 0) return 2;
+        return 3;
+    }
+
+    template <typename Fn>
+    decltype(auto) withMode(Fn&& fn){
+        if (isARCModeStarted && !isCLSModeStarted && !isINFModeStarted) return fn(ArcadeMode{});
+        if (isINFModeStarted && !isCLSModeStarted && !isARCModeStarted) return fn(InfiniteMode{});
+        if (isCLSModeStarted && !isINFModeStarted && !isARCModeStarted) return fn(ClassicMode{});
+        return fn(runtimeMode());
+    }
+
+    RuntimeMode runtimeMode() const {
+        return RuntimeMode::fromFlags(isCLSModeStarted, isINFModeStarted, isARCModeStarted);
+    }
+
+    void reseed(std::uint32_t seed){
+        genFood.seed(seed), genHoles.seed(seed + 1);
+    }
+
+    void resizeBoard(){
+        for (Snake& snake : snakes) snake.body.clear();
+        if (level){
+            boardWidth = level->width(), boardHeight = level->height();
+            snakeCount = std::min(snakeCount, static_cast<int>(level->spawns().size()));
+        }
+        bool isResized = board.width != boardWidth || board.height != boardHeight;
+        if (isResized) board.resize(boardWidth, boardHeight);
+        else if (!level) board.reset();
+        if (level) level->applyTo(board);
+        if (isResized || static_cast<int>(snakes.size()) != snakeCount){
+            snakes.clear();
+            snakes.reserve(snakeCount);
+            for (int i = 0; i < snakeCount; i++){
+                snakes.emplace_back(board, static_cast<std::uint8_t>(i));
+                snakes[i].body.resize();
+            }
+        }
+        for (int i = 0; i < snakeCount; i++){
+            if (level){
+                const LevelSpawn& spawn = level->spawns()[i];
+                snakes[i].spawnPos = sf::Vector2i(spawn.x, spawn.y), snakes[i].spawnDirection = toDirection(spawn.direction);
+            } else snakes[i].spawnPos = sf::Vector2i(board.width / 2 - 1, (i + 1) * board.height / (snakeCount + 1)), snakes[i].spawnDirection = sf::Vector2i(1, 0);
+        }
+    }
+
+    void restart(){
+        resizeBoard();
+        for (Snake& snake : snakes){
+            snake.body.pushBack(snake.spawnPos);
+            snake.direction = snake.spawnDirection;
+            snake.score = 0, snake.isAlive = true, snake.isGrowing = false, snake.moveCount = 0, snake.resetCount++;
+        }
+        gameScore = 1, snakeInt = 0, backgroundInt = 0, foodInt = 0;
+        levelCount++;
+        isNextLevel = false, youWon = false, youLose = false, isHoleSpawned = false, placedHoles = 0;
+        withMode([&](auto mode){ spawnHoles(mode); });
+        spawnFood();
+    }
+
+    bool turn(int snakeIndex, sf::Vector2i direction){
+        if (snakeIndex < 0 || snakeIndex >= static_cast<int>(snakes.size())) return false;
+        Snake& snake = snakes[snakeIndex];
+        if (!snake.isAlive || std::abs(direction.x) + std::abs(direction.y) != 1 || direction == -snake.direction) return false;
+        snake.direction = direction;
+        return true;
+    }
+
+    bool step(){
+        return withMode([&](auto mode){ return stepAs(mode); });
+    }
+
+    bool stepFlagDriven(){
+        return stepAs(runtimeMode());
+    }
+
+    template <typename Mode>
+    bool stepAs(const Mode& mode){
+        if (youLose || youWon) return false;
+        moveSnakes(mode);
+        snakeGrow(mode);
+        bool isEaten = isFoodEaten;
+        if (isFoodEaten) spawnFood();
+        if (mode.isWon(gameScore, static_cast<int>(board.openCellCount()))) youWon = true;
+        return isEaten;
+    }
+
+    void blockHole(sf::Vector2i holePos){
+        for (int y = 0; y < holeSize; y++){
+            for (int x = 0; x < holeSize; x++) board.block(holePos + sf::Vector2i(x, y));
+        }
+    }
+
+    template <typename Mode>
+    void spawnHoles(const Mode& mode){
+        if (!isHoleSpawned && mode.hasHoles && !level){
+            int requested = std::clamp(holeCount, 0, maxHoles);
+            std::array<HoleShape, maxHoles> shapes;
+            shapes.fill(HoleShape{holeSize, holeSize});
+            std::array<sf::Vector2i, BoardGrid::maxSnakes> spawns;
+            for (std::size_t i = 0; i < snakes.size(); i++) spawns[i] = snakes[i].spawnPos;
+            std::span<const HoleShape> requestedShapes(shapes.data(), requested);
+            std::span<const sf::Vector2i> spawnCells(spawns.data(), snakes.size());
+            if (!holePlacer || !holePlacer->matches(board.width, board.height, requestedShapes, spawnCells)){
+                holePlacer = std::make_shared<const HolePlacer>(board.width, board.height, std::vector<HoleShape>(requestedShapes.begin(), requestedShapes.end()), std::vector<sf::Vector2i>(spawnCells.begin(), spawnCells.end()));
+            }
+            placedHoles = holePlacer->sample(genHoles, std::span(holes.data(), requested));
+            if (placedHoles < requested) LOG_WARN("Not all holes fit on the board", "placed", placedHoles, "requested", requested, "width", board.width, "height", board.height);
+            for (int i = 0; i < placedHoles; i++) blockHole(holes[i]);
+            isHoleSpawned = true;
+        }
+    }
+
+    void snakeBodyCollision(Snake& snake){
+        if (board.isOccupied(snake.nextPos) && !isNextLevel){
+            snake.isAlive = false;
+            if (snake.isTailPopped) snake.body.pushBack(snake.tailPos);
+        }
+    }
+
+    template <typename Mode>
+    void moveSnakes(const Mode& mode){
+        bool wraps = level && level->wrapRule() != LevelFormat::ModeWraps ? level->wrapRule() == LevelFormat::AlwaysWraps : mode.wraps;
+        for (Snake& snake : snakes){
+            if (!snake.isAlive) continue;
+            snake.nextPos = snake.body.front() + snake.direction;
+            if (wraps && !board.isInside(snake.nextPos)){
+                snake.nextPos = sf::Vector2i((snake.nextPos.x + board.width) % board.width, (snake.nextPos.y + board.height) % board.height);
+            } else if (!board.isInside(snake.nextPos)) snake.isAlive = false;
+            if (snake.isAlive && board.isBlocked(snake.nextPos)) snake.isAlive = false;
+        }
+        for (Snake& snake : snakes){
+            snake.isTailPopped = snake.isAlive && !snake.isGrowing;
+            if (snake.isTailPopped){
+                snake.tailPos = snake.body.back();
+                snake.body.popBack();
+            }
+            if (snake.isAlive) snake.isGrowing = false;
+        }
+        for (Snake& snake : snakes){
+            if (snake.isAlive) snakeBodyCollision(snake);
+        }
+        for (Snake& snake : snakes){
+            if (!snake.isAlive) continue;
+            snake.body.pushFront(snake.nextPos);
+            snake.moveCount++;
+        }
+        youLose = true;
+        for (Snake& snake : snakes){
+            if (snake.isAlive && board.occupancyAt(snake.nextPos) > 1) snake.isAlive = false;
+            if (snake.isAlive) youLose = false;
+        }
+    }
+
+    template <typename Mode>
+    void snakeGrow(const Mode& mode){
+        for (Snake& snake : snakes){
+            if (!snake.isAlive || snake.body.front() != foodPos) continue;
+            isFoodEaten = true;
+            int points = 1;
+            if (mode.hasBonusFood){
+                foodInt++;
+                if (foodInt > mode.bonusFoodEvery){
+                    foodInt = 0;
+                    points = mode.bonusPoints;
+                    for (int i = 0; i < mode.bonusGrowth; i++) snake.body.pushBack(snake.body.back());
+                }
+            }
+            gameScore += points, snake.score += points;
+            if (mode.hasLevels && gameScore % static_cast<int>(board.openCellCount()) == 0 && gameScore != 0) nextLevel();
+            else {
+                snake.isGrowing = true;
+                isNextLevel = false;
+            }
+            break;
+        }
+    }
+
+    void spawnFood(){
+        if (!board.randomFreeCell(genFood, foodPos)) youWon = true;
+        isFoodEaten = false;
+    }
+
+    void nextLevel(){
+        isNextLevel = true;
+        snakeInt++, backgroundInt++;
+        if (snakeInt > 5) snakeInt = 0;
+        if (backgroundInt > 5) backgroundInt = 0;
+        levelCount++;
+        for (Snake& snake : snakes){
+            if (!snake.isAlive) continue;
+            sf::Vector2i head = snake.body.front();
+            snake.body.clear();
+            snake.body.pushBack(head);
+            snake.moveCount = 0, snake.resetCount++;
+        }
+    }
+};
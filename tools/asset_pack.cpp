@@ -0,0 +1,81 @@
+#include "../asset_pack.h"
+#include <fstream>
+#include <filesystem>
+
+bool readFile(const std::filesystem::path& path, std::vector<std::uint8_t>& data){
+    std::ifstream in(path, std::ios::binary);
+    if (!in){
+        std::cerr << "Failed to open " << path.string() << "\n";
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool collect(const std::filesystem::path& root, std::vector<AssetPack::Source>& sources){
+    std::vector<std::filesystem::path> paths;
+    if (std::filesystem::is_regular_file(root)) paths.push_back(root);
+    else if (std::filesystem::is_directory(root)){
+        for (const auto& item : std::filesystem::recursive_directory_iterator(root)){
+            if (item.is_regular_file()) paths.push_back(item.path());
+        }
+    } else {
+        std::cerr << root.string() << " does not exist\n";
+        return false;
+    }
+    for (const std::filesystem::path& path : paths){
+        AssetPack::Source source{path.lexically_normal().generic_string(), {}};
+        if (source.name.size() > UINT16_MAX || !readFile(path, source.data)) return false;
+        sources.push_back(std::move(source));
+    }
+    return true;
+}
+
+int listPack(const std::string& path){
+    AssetPack pack;
+    if (!pack.open(path)){
+        std::cerr << "Failed to open asset pack " << path << "\n";
+        return 1;
+    }
+    int corrupt = 0;
+    for (std::size_t i = 0; i < pack.size(); i++){
+        const AssetEntry& entry = pack.entry(i);
+        bool isIntact = !pack.view(i).empty() || entry.rawSize == 0;
+        corrupt += !isIntact;
+        std::cout << pack.name(i) << ", " << entry.rawSize << " bytes" << (entry.compression == AssetPack::Zlib ? ", zlib " + std::to_string(entry.storedSize) : std::string(", stored"))
+                  << ", hash " << std::hex << entry.contentHash << std::dec << (isIntact ? "" : ", CORRUPT") << "\n";
+    }
+    return corrupt ? 1 : 0;
+}
+
+int main(int argc, char* argv[]){
+    if (argc == 3 && std::string(argv[1]) == "--list") return listPack(argv[2]);
+    bool isCompressed = argc >= 2 && std::string(argv[1]) != "--store";
+    int first = isCompressed ? 1 : 2;
+    if (argc < first + 2){
+        std::cout << "Usage: asset_pack [--store] OUTPUT.pack PATH...\n"
+                     "       asset_pack --list INPUT.pack\n"
+                     "Directories are packed recursively; entries are named by their path as given, e.g. assets/sprites/food.png.\n";
+        return 1;
+    }
+    std::vector<AssetPack::Source> sources;
+    for (int i = first + 1; i < argc; i++){
+        if (!collect(argv[i], sources)) return 1;
+    }
+    std::sort(sources.begin(), sources.end(), [](const AssetPack::Source& a, const AssetPack::Source& b){ return a.name < b.name; });
+    auto duplicate = std::adjacent_find(sources.begin(), sources.end(), [](const AssetPack::Source& a, const AssetPack::Source& b){ return a.name == b.name; });
+    if (duplicate != sources.end()){
+        std::cerr << duplicate->name << " was given twice\n";
+        return 1;
+    }
+    std::size_t count = sources.size();
+    std::vector<std::uint8_t> pack = AssetPack::build(std::move(sources), isCompressed);
+    std::ofstream out(argv[first], std::ios::binary);
+    if (!out.write(reinterpret_cast<const char*>(pack.data()), static_cast<std::streamsize>(pack.size()))){
+        std::cerr << "Failed to write " << argv[first] << "\n";
+        return 1;
+    }
+    out.close();
+    std::cout << "Packed " << count << " assets into " << argv[first] << " (" << pack.size() << " bytes)\n";
+    return listPack(argv[first]);
+}
@@ -0,0 +1,105 @@
+#include "../snake_level.h"
+#include <fstream>
+#include <sstream>
+
+// Level sources are plain text: "name", "wrap" (mode|always|never) and "zone x y w h" lines, then "map"
+// followed by rows where '#' is an obstacle and '^' 'v' '<' '>' are spawn points facing that way.
+bool readLevel(const std::string& path, LevelLayout& layout){
+    std::ifstream in(path);
+    if (!in){
+        std::cerr << "Failed to open " << path << "\n";
+        return false;
+    }
+    std::string line;
+    std::vector<std::string> rows;
+    bool isMap = false;
+    while (std::getline(in, line)){
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (isMap){
+            rows.push_back(line);
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+        if (key == "name") std::getline(fields >> std::ws, layout.name);
+        else if (key == "wrap"){
+            std::string rule;
+            fields >> rule;
+            layout.wrapRule = rule == "always" ? LevelFormat::AlwaysWraps : rule == "never" ? LevelFormat::NeverWraps : LevelFormat::ModeWraps;
+        } else if (key == "zone"){
+            LevelZone zone;
+            if (!(fields >> zone.x >> zone.y >> zone.width >> zone.height)){
+                std::cerr << path << ": zone needs x y width height\n";
+                return false;
+            }
+            layout.zones.push_back(zone);
+        } else if (key == "map") isMap = true;
+        else if (!key.empty() && key[0] != ';'){
+            std::cerr << path << ": unknown key " << key << "\n";
+            return false;
+        }
+    }
+    while (!rows.empty() && rows.back().empty()) rows.pop_back();
+    if (rows.empty()){
+        std::cerr << path << ": missing map\n";
+        return false;
+    }
+    layout.width = static_cast<int>(rows[0].size()), layout.height = static_cast<int>(rows.size());
+    layout.obstacles.assign(static_cast<std::size_t>(layout.width) * layout.height, 0);
+    for (int y = 0; y < layout.height; y++){
+        if (static_cast<int>(rows[y].size()) != layout.width){
+            std::cerr << path << ": map row " << y + 1 << " is " << rows[y].size() << " cells wide, expected " << layout.width << "\n";
+            return false;
+        }
+        for (int x = 0; x < layout.width; x++){
+            char cell = rows[y][x];
+            std::size_t direction = std::string_view("^v<>").find(cell);
+            if (cell == '#') layout.obstacles[y * layout.width + x] = 1;
+            else if (direction != std::string_view::npos) layout.spawns.push_back(LevelSpawn{static_cast<std::uint16_t>(x), static_cast<std::uint16_t>(y), static_cast<std::uint8_t>(direction), {}});
+            else if (cell != '.' && cell != ' '){
+                std::cerr << path << ": unexpected '" << cell << "' at " << x << "," << y << "\n";
+                return false;
+            }
+        }
+    }
+    if (layout.name.empty()) layout.name = path;
+    return true;
+}
+
+int listPack(const std::string& path){
+    LevelPack pack;
+    if (!pack.open(path)) return 1;
+    for (std::size_t i = 0; i < pack.size(); i++){
+        if (!pack.load(i)) return 1;
+        const LevelView& level = pack[i];
+        std::size_t obstacles = std::count_if(level.cellFlags().begin(), level.cellFlags().end(), [](std::uint8_t flags){ return flags & BoardGrid::Obstacle; });
+        std::cout << i << ": " << level.name() << ", " << level.width() << "x" << level.height() << ", " << obstacles << " obstacle cells, "
+                  << level.spawns().size() << " spawns, " << level.zones().size() << " food zones, hash " << std::hex << level.contentHash() << std::dec << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]){
+    if (argc == 3 && std::string(argv[1]) == "--list") return listPack(argv[2]);
+    if (argc < 3){
+        std::cout << "Usage: level_pack OUTPUT.pack LEVEL.txt...\n"
+                     "       level_pack --list INPUT.pack\n";
+        return 1;
+    }
+    std::vector<std::vector<std::uint8_t>> levels;
+    for (int i = 2; i < argc; i++){
+        LevelLayout layout;
+        if (!readLevel(argv[i], layout)) return 1;
+        levels.push_back(layout.encode());
+        if (levels.back().empty()) return 1;
+    }
+    std::vector<std::uint8_t> pack = LevelPack::build(levels);
+    std::ofstream out(argv[1], std::ios::binary);
+    if (!out.write(reinterpret_cast<const char*>(pack.data()), static_cast<std::streamsize>(pack.size()))){
+        std::cerr << "Failed to write " << argv[1] << "\n";
+        return 1;
+    }
+    std::cout << "Packed " << levels.size() << " levels into " << argv[1] << " (" << pack.size() << " bytes)\n";
+    return listPack(argv[1]);
+}